@@ -0,0 +1,100 @@
+#include "shm_map.hpp"
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+const int N = 10000;
+
+typedef sjtu::shm_map<int, long long> Map;
+
+std::string segment_name() {
+	return "/sjtu_map_eight_" + std::to_string(getpid());
+}
+
+bool same(const Map &m, const std::map<int, long long> &ref) {
+	if (m.size() != ref.size()) return false;
+	auto it = m.cbegin();
+	for (auto &kv : ref) {
+		if (it->first != kv.first || it->second != kv.second) return false;
+		++it;
+	}
+	return it == m.cend();
+}
+
+void tester(void) {
+	std::string name = segment_name();
+	sjtu::shm_segment::remove(name.c_str());
+	std::map<int, long long> ref;
+	{
+		auto seg = sjtu::shm_segment::create(name.c_str(), 64 << 20);
+		Map *m = seg.construct<Map>("table", seg.get_allocator<int>());
+		for (int i = 0; i < N; ++i) {
+			int key = (int)(i * 7919LL % N);
+			(*m)[key] = 1LL * key * key;
+			ref[key] = 1LL * key * key;
+		}
+		for (int i = 0; i < N; i += 3) {
+			m->erase(m->find(i));
+			ref.erase(i);
+		}
+		std::cout << m->size() << " " << (same(*m, ref) ? "ok" : "wrong") << std::endl;
+		try {
+			seg.construct<Map>(std::string(100, 'x').c_str(), seg.get_allocator<int>());
+		} catch (sjtu::runtime_error &) {
+			std::cout << "name too long" << std::endl;
+		}
+		// the segment is unmapped here, the map stays in it
+	}
+	pid_t pid = fork();
+	if (pid == 0) {
+		// another process maps the segment, most likely at another address, and writes to the map
+		int status = 0;
+		try {
+			auto rw = sjtu::shm_segment::open(name.c_str(), false);
+			Map *m = rw.find<Map>("table");
+			if (m == nullptr || m->size() != ref.size() || m->at(1) != 1) {
+				status = 1;
+			} else {
+				for (int i = N; i < N + 1000; ++i) {
+					m->insert(sjtu::pair<const int, long long>(i, -i));
+				}
+				m->erase(m->find(2));
+			}
+		} catch (...) {
+			status = 3;
+		}
+		_exit(status);
+	}
+	int status;
+	waitpid(pid, &status, 0);
+	std::cout << "child exit " << (WIFEXITED(status) ? WEXITSTATUS(status) : -1) << std::endl;
+	for (int i = N; i < N + 1000; ++i) {
+		ref[i] = -i;
+	}
+	ref.erase(2);
+	{
+		auto ro = sjtu::shm_segment::open(name.c_str());
+		const Map *m = ro.find<Map>("table");
+		std::cout << (m != nullptr && same(*m, ref) ? "reopened ok" : "reopened wrong") << std::endl;
+		long long sum = 0;
+		for (int i = 0; i < N + 1000; i += 1000) {
+			auto it = m->find(i);
+			if (it != m->cend()) sum += it->second;
+		}
+		std::cout << m->size() << " " << m->count(2) << " " << sum << std::endl;
+		std::cout << (ro.find<Map>("missing") == nullptr) << std::endl;
+	}
+	{
+		auto rw = sjtu::shm_segment::open(name.c_str(), false);
+		rw.destroy<Map>("table");
+		std::cout << (rw.find<Map>("table") == nullptr) << std::endl;
+	}
+	sjtu::shm_segment::remove(name.c_str());
+}
+
+int main(void) {
+	tester();
+}
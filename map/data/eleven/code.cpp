@@ -0,0 +1,135 @@
+#include "map.hpp"
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+
+const int N = 200000;
+
+// counts the comparisons and copies of keys
+struct Key {
+	static long long compared;
+	static long long copied;
+	int v;
+	Key(int v) : v(v) {}
+	Key(const Key &other) : v(other.v) {
+		++copied;
+	}
+	bool operator < (const Key &rhs) const {
+		++compared;
+		return v < rhs.v;
+	}
+};
+
+long long Key::compared = 0;
+long long Key::copied = 0;
+
+typedef sjtu::map<Key, std::string> Map;
+
+bool same(const Map &map, const std::map<int, std::string> &ref) {
+	if (map.size() != ref.size()) return false;
+	auto it = map.cbegin();
+	for (auto &kv : ref) {
+		if (it == map.cend() || it->first.v != kv.first || it->second != kv.second) return false;
+		++it;
+	}
+	if (it != map.cend()) return false;
+	// and backwards, to check the links around the erased nodes
+	for (auto kv = ref.rbegin(); kv != ref.rend(); ++kv) {
+		--it;
+		if (it->first.v != kv->first) return false;
+	}
+	return it == map.cbegin();
+}
+
+void by_iterator(void) {
+	Map map;
+	std::map<int, std::string> ref;
+	for (int i = 0; i < 10; ++i) {
+		map[Key(i)] = std::to_string(i);
+		ref[i] = std::to_string(i);
+	}
+	// erase returns the next element, no key is compared or copied on the way
+	Key::compared = Key::copied = 0;
+	Map::iterator it = map.begin();
+	while (it != map.end()) {
+		if (it->first.v % 3 == 0) it = map.erase(it);
+		else ++it;
+	}
+	std::cout << Key::compared << " " << Key::copied << " " << map.size() << std::endl;
+	for (int i = 0; i < 10; i += 3) ref.erase(i);
+	std::cout << (same(map, ref) ? "ok" : "wrong") << std::endl;
+	Map::const_iterator last = --map.cend();
+	Map::iterator after = map.erase(last);
+	std::cout << (after == map.end()) << " " << map.size() << std::endl;
+	ref.erase(8);
+	std::cout << (same(map, ref) ? "ok" : "wrong") << std::endl;
+
+	std::cout << map.erase(Key(4)) << " " << map.erase(Key(4)) << " " << map.erase(Key(100)) << std::endl;
+	ref.erase(4);
+	std::cout << (same(map, ref) ? "ok" : "wrong") << std::endl;
+
+	try {
+		map.erase(map.end());
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << "end" << std::endl;
+	}
+	Map other = map;
+	try {
+		map.erase(other.begin());
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << "other map" << std::endl;
+	}
+	std::cout << map.size() << " " << other.size() << std::endl;
+	while (!map.empty()) map.erase(map.begin());
+	std::cout << map.size() << " " << (map.begin() == map.end()) << std::endl;
+}
+
+void random_erase(void) {
+	std::mt19937 rng(20261019);
+	Map map;
+	std::map<int, std::string> ref;
+	bool ok = true;
+	for (int i = 0; i < N; ++i) {
+		int key = rng() % (N / 10);
+		switch (rng() % 4) {
+		case 0:
+		case 1:
+			map[Key(key)] = std::to_string(i);
+			ref[key] = std::to_string(i);
+			break;
+		case 2: {
+			// erase the element found by lower_bound, compare the successors
+			auto a = map.lower_bound(Key(key));
+			auto b = ref.lower_bound(key);
+			if (a == map.end()) {
+				ok = ok && b == ref.end();
+				break;
+			}
+			a = map.erase(a);
+			b = ref.erase(b);
+			ok = ok && (a == map.end() ? b == ref.end() : b != ref.end() && a->first.v == b->first);
+			break;
+		}
+		default:
+			ok = ok && map.erase(Key(key)) == ref.erase(key);
+		}
+		if (i % (N / 10) == 0) ok = ok && same(map, ref);
+	}
+	std::cout << map.size() << " " << (ok && same(map, ref) ? "ok" : "wrong") << std::endl;
+	// drain from the middle outwards
+	auto it = map.lower_bound(Key(N / 20));
+	while (it != map.end()) it = map.erase(it);
+	while (!map.empty()) map.erase(--map.end());
+	std::cout << map.size() << " " << (map.cbegin() == map.cend()) << std::endl;
+}
+
+void tester(void) {
+	by_iterator();
+	random_erase();
+}
+
+int main(void) {
+	tester();
+	return 0;
+}
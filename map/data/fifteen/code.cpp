@@ -0,0 +1,109 @@
+#include "map.hpp"
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+
+const int N = 200000;
+
+// a key that counts how often it is built
+struct Id {
+	static long long built;
+	int v;
+	explicit Id(int v) : v(v) {
+		++built;
+	}
+	Id(const Id &other) : v(other.v) {
+		++built;
+	}
+};
+
+long long Id::built = 0;
+
+// compares ids with each other and with plain ints
+struct id_less {
+	typedef void is_transparent;
+	bool operator () (const Id &a, const Id &b) const {
+		return a.v < b.v;
+	}
+	bool operator () (const Id &a, int b) const {
+		return a.v < b;
+	}
+	bool operator () (int a, const Id &b) const {
+		return a < b.v;
+	}
+};
+
+typedef sjtu::map<std::string, int, std::less<>> Names;
+
+// without is_transparent a string_view is not a key
+template<typename M>
+concept finds_view = requires(M &m, std::string_view s) { m.find(s); };
+static_assert(finds_view<Names> && !finds_view<sjtu::map<std::string, int>>);
+
+void strings(void) {
+	Names names;
+	names["alice"] = 1;
+	names["bob"] = 2;
+	names["carol"] = 3;
+	std::string_view bob = "bob and more";
+	bob = bob.substr(0, 3);
+	std::cout << names.find(bob)->second << " " << names.count(bob) << " " << names.contains(std::string_view("dave")) << " " << names.at(std::string_view("carol")) << std::endl;
+	std::cout << names.lower_bound(std::string_view("b"))->first << " " << names.upper_bound(std::string_view("bob"))->first << std::endl;
+	auto eq = names.equal_range(std::string_view("alice"));
+	std::cout << eq.first->first << " " << eq.second->first << std::endl;
+	const char *c = "carol";
+	std::cout << names.find(c)->first << std::endl;
+	std::cout << names.erase(std::string_view("alice")) << " " << names.erase(std::string_view("alice")) << " " << names.size() << std::endl;
+	try {
+		names.at(std::string_view("alice"));
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "no alice" << std::endl;
+	}
+	const Names &cnames = names;
+	std::cout << (cnames.find(std::string_view("zed")) == cnames.cend()) << " " << cnames.at(std::string_view("bob")) << std::endl;
+	// erasing through an iterator still picks the iterator overload
+	names.erase(names.begin());
+	std::cout << names.size() << " " << names.begin()->first << std::endl;
+}
+
+void ids(void) {
+	std::mt19937 rng(20261019);
+	sjtu::map<Id, int, id_less> map;
+	std::map<int, int> ref;
+	for (int i = 0; i < N; ++i) {
+		int key = rng() % N;
+		map.try_emplace(Id(key), i);
+		ref.try_emplace(key, i);
+	}
+	// none of the lookups by int builds an Id
+	Id::built = 0;
+	bool ok = true;
+	for (int i = 0; i < N; ++i) {
+		int key = rng() % (N + 10) - 5;
+		auto it = map.find(key);
+		auto r = ref.find(key);
+		ok = ok && (it == map.end() ? r == ref.end() : r != ref.end() && it->second == r->second);
+		ok = ok && map.contains(key) == ref.contains(key) && map.count(key) == ref.count(key);
+		auto lb = map.lower_bound(key);
+		auto rlb = ref.lower_bound(key);
+		ok = ok && (lb == map.end() ? rlb == ref.end() : lb->first.v == rlb->first);
+		auto ub = map.upper_bound(key);
+		auto rub = ref.upper_bound(key);
+		ok = ok && (ub == map.end() ? rub == ref.end() : ub->first.v == rub->first);
+		if (i % 2) ok = ok && map.erase(key) == ref.erase(key);
+	}
+	std::cout << map.size() << " " << Id::built << " " << (ok ? "ok" : "wrong") << std::endl;
+}
+
+void tester(void) {
+	strings();
+	ids();
+}
+
+int main(void) {
+	tester();
+	return 0;
+}
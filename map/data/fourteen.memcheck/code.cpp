@@ -0,0 +1,107 @@
+#include "map.hpp"
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+const int N = 20000;
+
+typedef sjtu::map<int, std::string> Map;
+typedef sjtu::pair<int, std::string> Item;
+
+// counts the comparisons made by a map
+struct counting_less {
+	long long *count;
+	bool operator () (int a, int b) const {
+		++*count;
+		return a < b;
+	}
+};
+
+template<typename M>
+bool same(const M &map, const std::map<int, std::string> &ref) {
+	if (map.size() != ref.size()) return false;
+	auto it = map.cbegin();
+	for (auto &kv : ref) {
+		if (it == map.cend() || it->first != kv.first || it->second != kv.second) return false;
+		++it;
+	}
+	if (it != map.cend()) return false;
+	for (auto kv = ref.rbegin(); kv != ref.rend(); ++kv) {
+		--it;
+		if (it->first != kv->first) return false;
+	}
+	return true;
+}
+
+void small(void) {
+	std::vector<Item> items = {Item(1, "a"), Item(2, "b"), Item(2, "dup"), Item(5, "e"), Item(9, "i")};
+	Map map(items.begin(), items.end());
+	std::cout << map.size() << " " << map.at(2) << " " << map.begin()->first << " " << (--map.end())->first << std::endl;
+	// an unsorted range is inserted one by one, keeping the first of equal keys
+	std::vector<Item> shuffled = {Item(4, "d"), Item(1, "a"), Item(4, "again"), Item(3, "c")};
+	map.assign_sorted(shuffled.begin(), shuffled.end());
+	for (auto &kv : map) std::cout << kv.first << kv.second << " ";
+	std::cout << std::endl;
+	std::vector<Item> none;
+	map.assign_sorted(none.begin(), none.end());
+	std::cout << map.size() << " " << (map.begin() == map.end()) << std::endl;
+	map[7] = "g";
+	std::cout << map.size() << " " << map.begin()->second << std::endl;
+	// from the elements of another map
+	sjtu::map<int, int> squares;
+	for (int k : {8, 3, 5}) squares[k] = k * k;
+	sjtu::map<int, int> from(squares.cbegin(), squares.cend());
+	for (auto &kv : from) std::cout << kv.first << ":" << kv.second << " ";
+	std::cout << std::endl;
+}
+
+void big(void) {
+	std::mt19937 rng(20261019);
+	std::map<int, std::string> ref;
+	for (int i = 0; i < N; ++i) ref[rng() % (4 * N)] = std::to_string(i);
+	std::vector<Item> sorted;
+	for (auto &kv : ref) sorted.push_back(Item(kv.first, kv.second));
+
+	// a sorted range is checked with n - 1 comparisons and built without searching
+	long long count = 0;
+	sjtu::map<int, std::string, counting_less> built(sorted.begin(), sorted.end(), counting_less{&count});
+	std::cout << built.size() << " " << (same(built, ref) ? "ok" : "wrong") << " " << (count < 3LL * N) << std::endl;
+	count = 0;
+	sjtu::map<int, std::string, counting_less> inserted(counting_less{&count});
+	for (auto &item : sorted) inserted.insert(item);
+	std::cout << (count > 10LL * N) << std::endl;
+
+	// the built tree is a valid red-black tree: keep on changing it
+	Map map;
+	map.assign_sorted(sorted.begin(), sorted.end());
+	bool ok = same(map, ref);
+	for (int i = 0; i < N; ++i) {
+		int key = rng() % (4 * N);
+		if (rng() % 2) {
+			map[key] = "new";
+			ref[key] = "new";
+		} else {
+			map.erase(key);
+			ref.erase(key);
+		}
+	}
+	std::cout << map.size() << " " << (ok && same(map, ref) ? "ok" : "wrong") << std::endl;
+	// assigning replaces the old contents
+	sorted.resize(sorted.size() / 3);
+	map.assign_sorted(sorted.begin(), sorted.end());
+	std::map<int, std::string> third;
+	for (auto &item : sorted) third[item.first] = item.second;
+	std::cout << map.size() << " " << (same(map, third) ? "ok" : "wrong") << std::endl;
+}
+
+void tester(void) {
+	small();
+	big();
+}
+
+int main(void) {
+	tester();
+	return 0;
+}
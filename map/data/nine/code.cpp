@@ -0,0 +1,115 @@
+#include "map.hpp"
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+const int N = 200000;
+const int KEYS = 5000;
+
+long long outstanding = 0;
+
+// counts the objects handed out and not yet given back
+template<typename T>
+class counting_allocator {
+public:
+	typedef T value_type;
+
+	counting_allocator() = default;
+	template<typename U>
+	counting_allocator(const counting_allocator<U> &) {}
+
+	T *allocate(size_t n) {
+		outstanding += n;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T *p, size_t n) {
+		outstanding -= n;
+		std::allocator<T>().deallocate(p, n);
+	}
+	template<typename U>
+	bool operator == (const counting_allocator<U> &) const {
+		return true;
+	}
+};
+
+// every node is allocated on its own
+typedef sjtu::map<int, std::string, std::less<int>, counting_allocator<sjtu::pair<const int, std::string>>,
+                  sjtu::null_node_update, false> Map;
+typedef sjtu::map<int, std::string, std::less<int>, counting_allocator<sjtu::pair<const int, std::string>>> Pooled;
+
+template<typename M>
+bool same(const M &map, const std::map<int, std::string> &ref) {
+	if (map.size() != ref.size()) return false;
+	auto it = map.cbegin();
+	for (auto &kv : ref) {
+		if (it == map.cend() || it->first != kv.first || it->second != kv.second) return false;
+		++it;
+	}
+	return it == map.cend();
+}
+
+std::string value(int key, int round) {
+	return "value of " + std::to_string(key) + " written in round " + std::to_string(round);
+}
+
+void tester(void) {
+	std::mt19937 rng(20261019);
+	Map map;
+	std::map<int, std::string> ref;
+	bool ok = true;
+	for (int i = 0; i < N; ++i) {
+		int key = rng() % KEYS;
+		if (rng() % 2) {
+			map.erase(key);
+			ref.erase(key);
+		} else {
+			map[key] = value(key, 0);
+			ref[key] = value(key, 0);
+		}
+		// a removed node goes straight back to the allocator
+		if (i % 1000 == 0 && outstanding != (long long)map.size()) ok = false;
+	}
+	std::cout << map.size() << " " << (same(map, ref) && ok ? "ok" : "wrong") << std::endl;
+
+	Map other;
+	std::map<int, std::string> ref2;
+	for (int key = 0; key < KEYS; key += 3) {
+		other[key] = value(key, 1);
+		ref2[key] = value(key, 1);
+	}
+	Map copy(map);
+	copy.set_intersection(other);
+	map.merge(other);
+	for (auto &kv : ref2) {
+		ref.emplace(kv.first, kv.second);
+	}
+	std::cout << map.size() << " " << other.size() << " " << copy.size() << " " << (same(map, ref) ? "ok" : "wrong") << std::endl;
+	std::cout << (outstanding == (long long)(map.size() + copy.size())) << std::endl;
+	copy = map;
+	copy.set_difference(std::move(map), true);
+	std::cout << copy.size() << " " << map.size() << " " << (outstanding == 0) << std::endl;
+
+	map.clear();
+	for (int key = 0; key < 100; ++key) {
+		map[key] = value(key, 2);
+	}
+	std::cout << map.size() << " " << outstanding << std::endl;
+	{
+		Pooled pooled;
+		for (int key = 0; key < 100; ++key) {
+			pooled[key] = value(key, 3);
+		}
+		// the pooled map takes whole slabs, so more than its nodes
+		std::cout << pooled.size() << " " << (outstanding - 100 > 100) << std::endl;
+	}
+	map.clear();
+	std::cout << outstanding << std::endl;
+}
+
+int main(void) {
+	tester();
+	std::cout << outstanding << std::endl;
+}
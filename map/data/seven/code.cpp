@@ -0,0 +1,216 @@
+#include "map.hpp"
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+const int ROUNDS = 2000;
+const int BIG = 200000;
+
+size_t allocations = 0;
+
+// counts the slabs taken from the allocator
+template<typename T>
+class counting_allocator {
+public:
+	typedef T value_type;
+
+	counting_allocator() = default;
+	template<typename U>
+	counting_allocator(const counting_allocator<U> &) {}
+
+	T *allocate(size_t n) {
+		++allocations;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T *p, size_t n) {
+		std::allocator<T>().deallocate(p, n);
+	}
+	template<typename U>
+	bool operator == (const counting_allocator<U> &) const {
+		return true;
+	}
+};
+
+typedef sjtu::map<int, int> Plain;
+typedef sjtu::map<int, int, std::less<int>, std::allocator<sjtu::pair<const int, int>>,
+                  sjtu::order_statistics_node_update> Ranked;
+typedef sjtu::map<int, std::string, std::less<int>, counting_allocator<sjtu::pair<const int, std::string>>> Counted;
+
+// returns the number of nodes below x, or -1 if a red-black or count invariant is broken
+template<typename Map>
+long long check(typename Map::RBTree::NodePtr x, typename Map::RBTree::NodePtr parent, size_t &black) {
+	typedef typename Map::RBTree Tree;
+	if (x == nullptr) {
+		black = 1;
+		return 0;
+	}
+	if (x->parent != parent) return -1;
+	if (x->color == Tree::RED) {
+		if ((x->left && x->left->color == Tree::RED) || (x->right && x->right->color == Tree::RED)) return -1;
+	}
+	size_t lb, rb;
+	long long l = check<Map>(x->left, x, lb), r = check<Map>(x->right, x, rb);
+	if (l < 0 || r < 0 || lb != rb) return -1;
+	black = lb + (x->color == Tree::BLACK);
+	long long n = l + r + 1;
+	if constexpr (Tree::ORDER_STATISTICS) {
+		if ((long long)x->cnt.n != n) return -1;
+	}
+	return n;
+}
+
+template<typename Map>
+bool valid(const Map &map, const std::map<int, int> &ref) {
+	size_t black;
+	if (map.m_root && map.m_root->color != Map::RBTree::BLACK) return false;
+	if (check<Map>(map.m_root, nullptr, black) != (long long)ref.size() || map.size() != ref.size()) return false;
+	auto it = map.cbegin();
+	for (auto &kv : ref) {
+		if (it == map.cend() || it->first != kv.first || it->second != kv.second) return false;
+		++it;
+	}
+	if (it != map.cend()) return false;
+	if (!ref.empty() && (--map.cend())->first != ref.rbegin()->first) return false;
+	if constexpr (Map::RBTree::ORDER_STATISTICS) {
+		int i = 0;
+		for (auto &kv : ref) {
+			if (map.select(i)->first != kv.first || map.rank(kv.first) != (size_t)i) return false;
+			++i;
+		}
+	}
+	return true;
+}
+
+// op 0..2 take other by rvalue, 3..5 by const reference; union, intersection, difference
+template<typename Map>
+void apply(Map &a, Map &b, int op, bool parallel) {
+	switch (op) {
+		case 0: a.set_union(std::move(b), parallel); break;
+		case 1: a.set_intersection(std::move(b), parallel); break;
+		case 2: a.set_difference(std::move(b), parallel); break;
+		case 3: a.set_union(b, parallel); break;
+		case 4: a.set_intersection(b, parallel); break;
+		default: a.set_difference(b, parallel); break;
+	}
+}
+
+std::map<int, int> expected(const std::map<int, int> &a, const std::map<int, int> &b, int op) {
+	std::map<int, int> res;
+	for (auto &kv : a) {
+		bool in_b = b.count(kv.first);
+		if (op % 3 == 0 || (op % 3 == 1 && in_b) || (op % 3 == 2 && !in_b)) res.insert(kv);
+	}
+	if (op % 3 == 0) {
+		for (auto &kv : b) res.emplace(kv.first, kv.second);
+	}
+	return res;
+}
+
+template<typename Map>
+void TestRandom(const char *name, bool parallel) {
+	std::mt19937 rng(20261019);
+	int bad = 0;
+	for (int round = 0; round < ROUNDS; ++round) {
+		int na = rng() % (round % 10 == 0 ? 3000 : 60);
+		int nb = rng() % (round % 7 == 0 ? 3000 : 60);
+		int range = rng() % 5000 + 1;
+		Map a, b;
+		std::map<int, int> ra, rb;
+		for (int i = 0; i < na; ++i) {
+			int k = rng() % range;
+			a[k] = i;
+			ra[k] = i;
+		}
+		for (int i = 0; i < nb; ++i) {
+			int k = rng() % range;
+			b[k] = -i - 1;
+			rb[k] = -i - 1;
+		}
+		// leave free nodes in both pools
+		for (int i = 0; i < 3 && !ra.empty(); ++i) {
+			int k = ra.begin()->first;
+			a.erase(a.find(k));
+			ra.erase(k);
+		}
+		if (!rb.empty()) {
+			b.erase(--b.end());
+			rb.erase(--rb.end());
+		}
+		int op = rng() % 7;
+		std::map<int, int> res = op == 6 ? expected(ra, rb, 0) : expected(ra, rb, op);
+		if (op == 6) a.merge(b, parallel);
+		else apply(a, b, op, parallel);
+		if (!valid(a, res)) ++bad;
+		if (op < 3 || op == 6) {
+			if (!b.empty() || b.begin() != b.end()) ++bad;
+			rb.clear();
+		} else if (!valid(b, rb)) {
+			++bad;
+		}
+		// both pools still work
+		for (int k = -50; k < 0; ++k) {
+			a[k] = k;
+			res[k] = k;
+			b[k] = k;
+			rb[k] = k;
+		}
+		if (!valid(a, res) || !valid(b, rb)) ++bad;
+		Map c(a);
+		if (!valid(c, res)) ++bad;
+	}
+	std::cout << name << (parallel ? " parallel " : " sequential ") << (bad ? "wrong" : "ok") << std::endl;
+}
+
+void TestBig() {
+	Ranked a, b;
+	std::map<int, int> ra, rb;
+	for (int i = 0; i < BIG; ++i) {
+		a[2 * i] = i;
+		ra[2 * i] = i;
+		b[3 * i] = -i;
+		rb[3 * i] = -i;
+	}
+	Ranked u(a), n(a), d(a);
+	u.set_union(b, true);
+	n.set_intersection(b, true);
+	d.set_difference(b, true);
+	std::cout << u.size() << " " << n.size() << " " << d.size() << std::endl;
+	bool ok = valid(u, expected(ra, rb, 0)) && valid(n, expected(ra, rb, 1)) && valid(d, expected(ra, rb, 2));
+	a.merge(b, true);
+	ok = ok && valid(a, expected(ra, rb, 0)) && b.empty();
+	std::cout << (ok ? "ok" : "wrong") << std::endl;
+}
+
+// the free nodes and never-used nodes of a merged map are reused before a new slab is taken
+void TestPoolReuse() {
+	Counted a, b;
+	for (int i = 0; i < 1000; ++i) {
+		a[i] = "a" + std::to_string(i);
+		b[i + 5000] = "b" + std::to_string(i);
+	}
+	for (int i = 0; i < 1000; i += 2) {
+		a.erase(i);
+		b.erase(i + 5000);
+	}
+	size_t spare = a.m_bump_left + b.m_bump_left + 500 + 500;
+	size_t before = allocations;
+	a.merge(b);
+	for (size_t i = 0; i < spare; ++i) {
+		a[10000 + (int)i] = "c";
+	}
+	std::cout << a.size() << " " << (allocations == before ? "no new slab" : "new slab") << std::endl;
+	a[-1] = "d";
+	std::cout << a.size() << " " << (allocations == before + 1 ? "one new slab" : "wrong") << std::endl;
+}
+
+int main(void) {
+	TestRandom<Plain>("plain", false);
+	TestRandom<Plain>("plain", true);
+	TestRandom<Ranked>("ranked", false);
+	TestRandom<Ranked>("ranked", true);
+	TestBig();
+	TestPoolReuse();
+}
@@ -0,0 +1,115 @@
+#include "map.hpp"
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+
+const int N = 300000;
+const int KEYS = 5000;
+
+class Integer {
+public:
+	static int counter;
+	int val;
+
+	Integer(int val) : val(val) {
+		counter++;
+	}
+
+	Integer(const Integer &rhs) {
+		val = rhs.val;
+		counter++;
+	}
+
+	~Integer() {
+		counter--;
+	}
+};
+
+int Integer::counter = 0;
+
+class Compare {
+public:
+	bool operator () (const Integer &lhs, const Integer &rhs) const {
+		return lhs.val < rhs.val;
+	}
+};
+
+typedef sjtu::map<Integer, std::string, Compare> Map;
+
+std::string value(int key, int round) {
+	// long enough to live on the heap
+	return "value of " + std::to_string(key) + " written in round " + std::to_string(round);
+}
+
+bool same(const Map &map, const std::map<int, std::string> &ref) {
+	if (map.size() != ref.size()) return false;
+	auto it = map.cbegin();
+	for (auto &kv : ref) {
+		if (it == map.cend() || it->first.val != kv.first || it->second != kv.second) return false;
+		++it;
+	}
+	return it == map.cend();
+}
+
+void interleave(Map &map, std::map<int, std::string> &ref, std::mt19937 &rng, int round) {
+	for (int i = 0; i < N; ++i) {
+		int key = rng() % KEYS;
+		if (rng() % 2) {
+			auto it = map.find(Integer(key));
+			if (it != map.end()) map.erase(it);
+			ref.erase(key);
+		} else {
+			map[Integer(key)] = value(key, round);
+			ref[key] = value(key, round);
+		}
+	}
+}
+
+void tester(void) {
+	std::mt19937 rng(20261019);
+	Map map;
+	std::map<int, std::string> ref;
+	interleave(map, ref, rng, 0);
+	std::cout << map.size() << " " << (same(map, ref) ? "ok" : "wrong") << std::endl;
+
+	// erase a run of neighbours and put them back, so freed nodes are reused at once
+	for (int round = 1; round <= 3; ++round) {
+		for (int key = 1000; key < 3000; ++key) {
+			map.erase(Integer(key));
+			ref.erase(key);
+		}
+		for (int key = 2999; key >= 1000; --key) {
+			map.insert(sjtu::pair<Integer, std::string>(Integer(key), value(key, round)));
+			ref[key] = value(key, round);
+		}
+		std::cout << map.size() << " " << (same(map, ref) ? "ok" : "wrong") << std::endl;
+	}
+
+	{
+		Map copy(map);
+		Map other;
+		other[Integer(-1)] = "other";
+		other = map;
+		map.clear();
+		std::cout << map.size() << " " << (map.begin() == map.end()) << " "
+		          << (same(copy, ref) && same(other, ref) ? "ok" : "wrong") << std::endl;
+	}
+
+	ref.clear();
+	std::cout << Integer::counter << std::endl;
+	interleave(map, ref, rng, 4);
+	std::cout << map.size() << " " << (same(map, ref) ? "ok" : "wrong") << std::endl;
+	map.clear();
+	ref.clear();
+	for (int key = 0; key < KEYS; ++key) {
+		map[Integer(key)] = value(key, 5);
+		ref[key] = value(key, 5);
+	}
+	std::cout << map.size() << " " << (same(map, ref) ? "ok" : "wrong") << std::endl;
+}
+
+int main(void) {
+	tester();
+	std::cout << Integer::counter << std::endl;
+}
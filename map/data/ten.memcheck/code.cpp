@@ -0,0 +1,130 @@
+#include "map.hpp"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+const int N = 20000;
+const int KEYS = 5000;
+
+// not default constructible, counts how it is made
+struct Payload {
+	static int constructed;
+	static int copied;
+	static int moved;
+	std::string text;
+	int weight;
+	Payload(const std::string &text, int weight) : text(text), weight(weight) {
+		++constructed;
+	}
+	Payload(std::unique_ptr<int> p) : text("owned"), weight(*p) {
+		++constructed;
+	}
+	Payload(const Payload &other) : text(other.text), weight(other.weight) {
+		++copied;
+	}
+	Payload(Payload &&other) : text(std::move(other.text)), weight(other.weight) {
+		++moved;
+	}
+	Payload &operator = (const Payload &other) = default;
+	Payload &operator = (Payload &&other) = default;
+};
+
+int Payload::constructed = 0;
+int Payload::copied = 0;
+int Payload::moved = 0;
+
+typedef sjtu::map<std::string, Payload> Map;
+
+void reset() {
+	Payload::constructed = Payload::copied = Payload::moved = 0;
+}
+
+void counts() {
+	std::cout << Payload::constructed << " " << Payload::copied << " " << Payload::moved << std::endl;
+}
+
+void in_place(void) {
+	Map map;
+	reset();
+	auto r = map.try_emplace("a", "alpha", 1);
+	std::cout << r.second << " " << r.first->first << " " << r.first->second.text << " " << r.first->second.weight << std::endl;
+	counts();
+	// the key exists: the arguments are not touched, not even moved from
+	std::unique_ptr<int> p(new int(7));
+	auto r2 = map.try_emplace("a", std::move(p));
+	std::cout << r2.second << " " << r2.first->second.text << " " << (p != nullptr) << std::endl;
+	auto r3 = map.try_emplace(std::string("b"), std::move(p));
+	std::cout << r3.second << " " << r3.first->second.text << " " << r3.first->second.weight << " " << (p == nullptr) << std::endl;
+	counts();
+
+	reset();
+	auto r4 = map.insert_or_assign("a", Payload("again", 2));
+	std::cout << r4.second << " " << map.at("a").text << " " << map.at("a").weight << std::endl;
+	Payload c("copied", 3);
+	auto r5 = map.insert_or_assign(std::string("c"), c);
+	std::cout << r5.second << " " << map.at("c").text << " " << c.text << " " << map.size() << std::endl;
+	counts();
+
+	reset();
+	// emplace builds the element first and drops it if the key exists
+	auto e = map.emplace("d", Payload("delta", 4));
+	std::cout << e.second << " " << e.first->second.text << std::endl;
+	auto e2 = map.emplace(std::string("d"), Payload("ignored", 5));
+	std::cout << e2.second << " " << e2.first->second.text << " " << map.size() << std::endl;
+	auto e3 = map.emplace(std::piecewise_construct, std::forward_as_tuple("e"), std::forward_as_tuple("echo", 6));
+	std::cout << e3.second << " " << e3.first->second.text << " " << e3.first->second.weight << std::endl;
+	counts();
+	for (auto &kv : map) std::cout << kv.first << ":" << kv.second.text << " ";
+	std::cout << std::endl;
+}
+
+void random_ops(void) {
+	std::mt19937 rng(20261019);
+	sjtu::map<int, long long> map;
+	std::map<int, long long> ref;
+	bool ok = true;
+	for (int i = 0; i < N; ++i) {
+		int key = rng() % KEYS;
+		long long v = rng();
+		switch (rng() % 4) {
+		case 0: {
+			auto a = map.try_emplace(key, v);
+			auto b = ref.try_emplace(key, v);
+			ok = ok && a.second == b.second && a.first->second == b.first->second;
+			break;
+		}
+		case 1: {
+			auto a = map.insert_or_assign(key, v);
+			auto b = ref.insert_or_assign(key, v);
+			ok = ok && a.second == b.second && a.first->second == v;
+			break;
+		}
+		case 2: {
+			auto a = map.emplace(key, v);
+			auto b = ref.emplace(key, v);
+			ok = ok && a.second == b.second && a.first->second == b.first->second;
+			break;
+		}
+		default:
+			ok = ok && map.erase(key) == ref.erase(key);
+		}
+	}
+	auto it = map.cbegin();
+	for (auto &kv : ref) {
+		ok = ok && it != map.cend() && it->first == kv.first && it->second == kv.second;
+		++it;
+	}
+	std::cout << map.size() << " " << (ok && it == map.cend() ? "ok" : "wrong") << std::endl;
+}
+
+void tester(void) {
+	in_place();
+	random_ops();
+}
+
+int main(void) {
+	tester();
+	return 0;
+}
@@ -0,0 +1,122 @@
+#include "map.hpp"
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+const int N = 100000;
+
+typedef sjtu::map<int, int, std::less<int>, std::allocator<sjtu::pair<const int, int>>,
+                  sjtu::order_statistics_node_update> Map;
+
+// the order statistics are only there with the policy
+template<typename M>
+concept has_select = requires(M &m) { m.select(0); m.rank(0); };
+static_assert(has_select<Map> && !has_select<sjtu::map<int, int>>);
+
+// checks every order statistic against the sorted keys of ref
+bool check(const Map &map, const std::map<int, int> &ref, std::mt19937 &rng) {
+	if (map.size() != ref.size()) return false;
+	std::vector<int> keys;
+	for (auto &kv : ref) keys.push_back(kv.first);
+	if (map.select(keys.size()) != map.cend()) return false;
+	for (int t = 0; t < 200 && !keys.empty(); ++t) {
+		size_t k = rng() % keys.size();
+		if (map.select(k)->first != keys[k]) return false;
+		int key = keys[k] + int(rng() % 3) - 1;
+		size_t r = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+		if (map.rank(key) != r) return false;
+		int hi = key + int(rng() % 1000);
+		size_t c = std::lower_bound(keys.begin(), keys.end(), hi) - keys.begin() - r;
+		if (map.count_range(key, hi) != c || map.count_range(hi, key) != (hi == key ? c : 0)) return false;
+		// iterator jumps and distances
+		Map::const_iterator it = map.cbegin() + k;
+		if (it->first != keys[k] || it - map.cbegin() != (long)k || map.cend() - it != (long)(keys.size() - k)) return false;
+		size_t j = rng() % keys.size();
+		it += (long)j - (long)k;
+		if (it->first != keys[j] || (it - (long)j) != map.cbegin()) return false;
+	}
+	return true;
+}
+
+void small(void) {
+	Map map;
+	std::cout << map.rank(5) << " " << (map.select(0) == map.end()) << " " << map.count_range(0, 10) << std::endl;
+	for (int i = 1; i <= 9; ++i) map[i * 10] = i;
+	std::cout << map.select(0)->first << " " << map.select(4)->first << " " << map.select(8)->first << " " << (map.select(9) == map.end()) << std::endl;
+	std::cout << map.rank(10) << " " << map.rank(15) << " " << map.rank(90) << " " << map.rank(1000) << std::endl;
+	std::cout << map.count_range(20, 50) << " " << map.count_range(15, 55) << " " << map.count_range(50, 20) << " " << map.count_range(0, 1000) << std::endl;
+	Map::iterator it = map.begin() + 3;
+	std::cout << it->first << " " << (it + 2)->first << " " << (it - 3)->first << " " << (map.end() - it) << " " << (map.begin() - it) << std::endl;
+	it += 6;
+	std::cout << (it == map.end()) << std::endl;
+	try {
+		it += 1;
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << "past the end" << std::endl;
+	}
+	try {
+		map.begin() - 1;
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << "before the beginning" << std::endl;
+	}
+	map.erase(40);
+	map.erase(map.select(0));
+	std::cout << map.select(0)->first << " " << map.select(2)->first << " " << map.rank(50) << std::endl;
+}
+
+void random_ops(void) {
+	std::mt19937 rng(20261019);
+	Map map;
+	std::map<int, int> ref;
+	bool ok = true;
+	for (int i = 0; i < N; ++i) {
+		int key = rng() % (N / 2);
+		if (rng() % 3) {
+			map[key] = i;
+			ref[key] = i;
+		} else {
+			map.erase(key);
+			ref.erase(key);
+		}
+		if (i % (N / 10) == 0) ok = ok && check(map, ref, rng);
+	}
+	std::cout << map.size() << " " << (ok && check(map, ref, rng) ? "ok" : "wrong") << std::endl;
+
+	// the subtree sizes survive copies, sorted builds and the set algebra
+	Map copy = map;
+	Map other;
+	std::map<int, int> ref_other;
+	for (int i = 0; i < N / 2; ++i) {
+		int key = rng() % N;
+		other[key] = -i;
+		ref_other[key] = -i;
+	}
+	std::vector<sjtu::pair<int, int>> sorted;
+	for (auto &kv : ref_other) sorted.push_back(sjtu::pair<int, int>(kv.first, kv.second));
+	Map built;
+	built.assign_sorted(sorted.begin(), sorted.end());
+	std::cout << (check(copy, ref, rng) ? "ok" : "wrong") << " " << (check(built, ref_other, rng) ? "ok" : "wrong") << std::endl;
+
+	std::map<int, int> ref_union = ref, ref_inter, ref_diff;
+	for (auto &kv : ref_other) ref_union.insert(kv);
+	for (auto &kv : ref) (ref_other.count(kv.first) ? ref_inter : ref_diff).insert(kv);
+	Map u = map, in = map, d = map;
+	u.set_union(other);
+	in.set_intersection(other);
+	d.set_difference(std::move(built));
+	std::cout << (check(u, ref_union, rng) ? "ok" : "wrong") << " " << (check(in, ref_inter, rng) ? "ok" : "wrong") << " "
+	          << (check(d, ref_diff, rng) ? "ok" : "wrong") << std::endl;
+}
+
+void tester(void) {
+	small();
+	random_ops();
+}
+
+int main(void) {
+	tester();
+	return 0;
+}
@@ -0,0 +1,88 @@
+#include "map.hpp"
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <ranges>
+#include <string>
+
+const int N = 200000;
+
+typedef sjtu::map<int, long long> Map;
+
+template<typename It, typename RefIt>
+bool same_pos(const Map &map, It a, const std::map<int, long long> &ref, RefIt b) {
+	if (a == map.cend() || b == ref.end()) return a == map.cend() && b == ref.end();
+	return a->first == b->first && a->second == b->second;
+}
+
+void small(void) {
+	Map map;
+	std::cout << (map.lower_bound(1) == map.end()) << (map.upper_bound(1) == map.end()) << " " << std::ranges::distance(map.range(0, 10)) << std::endl;
+	for (int i = 10; i <= 50; i += 10) map[i] = i * i;
+	std::cout << map.lower_bound(10)->first << " " << map.lower_bound(11)->first << " " << map.upper_bound(10)->first << " " << map.lower_bound(5)->first << std::endl;
+	std::cout << (map.lower_bound(51) == map.end()) << (map.upper_bound(50) == map.end()) << std::endl;
+	auto eq = map.equal_range(30);
+	std::cout << eq.first->first << " " << eq.second->first << std::endl;
+	auto none = map.equal_range(35);
+	std::cout << (none.first == none.second) << " " << none.first->first << std::endl;
+	for (auto &[k, v] : map.range(15, 45)) std::cout << k << ":" << v << " ";
+	std::cout << std::endl;
+	// the values can be changed through the view
+	for (auto &kv : map.range(20, 40)) kv.second = -kv.second;
+	for (auto &kv : map) std::cout << kv.second << " ";
+	std::cout << std::endl;
+	// empty and reversed bounds give an empty view
+	std::cout << std::ranges::distance(map.range(30, 30)) << " " << std::ranges::distance(map.range(40, 20)) << " " << std::ranges::distance(map.range(0, 1000)) << std::endl;
+	const Map &cmap = map;
+	auto cr = cmap.range(25, 100);
+	std::cout << std::ranges::distance(cr) << " " << cr.begin()->first << " " << cmap.lower_bound(21)->first << " " << cmap.upper_bound(21)->first << std::endl;
+	auto ceq = cmap.equal_range(50);
+	std::cout << ceq.first->first << " " << (ceq.second == cmap.cend()) << std::endl;
+	// a descending map
+	sjtu::map<int, int, std::greater<int>> desc;
+	for (int i = 1; i <= 5; ++i) desc[i] = i;
+	std::cout << desc.lower_bound(3)->first << " " << desc.upper_bound(3)->first << " ";
+	for (auto &kv : desc.range(4, 1)) std::cout << kv.first;
+	std::cout << std::endl;
+}
+
+void random_bounds(void) {
+	std::mt19937 rng(20261019);
+	Map map;
+	std::map<int, long long> ref;
+	for (int i = 0; i < N; ++i) {
+		int key = rng() % (4 * N);
+		map[key] = i;
+		ref[key] = i;
+	}
+	bool ok = true;
+	for (int i = 0; i < N; ++i) {
+		int key = int(rng() % (4 * N + 20)) - 10;
+		ok = ok && same_pos(map, map.lower_bound(key), ref, ref.lower_bound(key));
+		ok = ok && same_pos(map, map.upper_bound(key), ref, ref.upper_bound(key));
+		auto eq = map.equal_range(key);
+		ok = ok && (eq.first != eq.second) == (ref.count(key) > 0);
+		if (i % 100 == 0) {
+			int hi = key + int(rng() % 1000);
+			auto r = map.range(key, hi);
+			auto b = ref.lower_bound(key), e = ref.lower_bound(hi);
+			for (auto &kv : r) {
+				ok = ok && b != e && kv.first == b->first && kv.second == b->second;
+				++b;
+			}
+			ok = ok && b == e;
+		}
+	}
+	std::cout << map.size() << " " << (ok ? "ok" : "wrong") << std::endl;
+}
+
+void tester(void) {
+	small();
+	random_bounds();
+}
+
+int main(void) {
+	tester();
+	return 0;
+}
@@ -11,8 +11,18 @@
 #include "exceptions.hpp"
 
 #include <iostream>
+#include <bit>
 #include <cassert>
+#include <future>
 #include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace sjtu {
 
@@ -23,23 +33,72 @@ void swap(Tp &a, Tp &b) {
     b = tmp;
 }
 
-template <class Key, class Val, class Compare = std::less<Key>> class RBTree {
+/**
+ * node update policies of RBTree / map:
+ *   null_node_update keeps nothing extra (the default),
+ *   order_statistics_node_update keeps the size of every subtree, which adds
+ *   select(k), rank(key), count_range(lo, hi) and O(log n) iterator jumps.
+ */
+struct null_node_update {};
+struct order_statistics_node_update {};
+
+/**
+ * a comparator with is_transparent compares Key with other types, so the lookups
+ * of map take any such type (e.g. a string_view for string keys) without building a Key.
+ */
+template <class Compare>
+concept transparent_compare = requires { typename Compare::is_transparent; };
+
+/**
+ * Alloc allocates pair<const Key, Val> like std::map, it is rebound to Node.
+ * The node links use the pointer type of the allocator, so a fancy pointer
+ * (e.g. offset_ptr for trees living in shared memory) is supported.
+ *
+ * by default (NodePool) the nodes come from a pool owned by the tree: Alloc only
+ * hands out slabs of nodes (doubling from MIN_SLAB to MAX_SLAB nodes), new nodes
+ * are carved from the last slab in order, and removed nodes go to a free list
+ * for reuse. clear() and the destructor give all the slabs back at once, without
+ * visiting the nodes if the elements are trivially destructible.
+ * With NodePool = false every node is allocated from Alloc on its own and given
+ * back as soon as it is removed (e.g. if Alloc is a pool already, or to let a
+ * leak checker see every node).
+ */
+template <class Key, class Val, class Compare = std::less<Key>,
+          class Alloc = std::allocator<pair<const Key, Val>>,
+          class Policy = null_node_update, bool NodePool = true> class RBTree {
   public:
     typedef pair<const Key, Val> data_type;
     typedef Key                  key_type;
     typedef Val                  value_type;
 
     enum ColorT { RED, BLACK };
+    struct Node;
+
+    static constexpr bool ORDER_STATISTICS = std::is_same_v<Policy, order_statistics_node_update>;
+
+    // the size of the subtree, an empty member without order statistics
+    struct no_count {};
+    struct subtree_count {
+        size_t n = 1;
+    };
+    typedef std::conditional_t<ORDER_STATISTICS, subtree_count, no_count> count_type;
+
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Node> node_allocator;
+    typedef std::allocator_traits<node_allocator> node_traits;
+    typedef typename node_traits::pointer         NodePtr;
+
     struct Node {
-        typedef Node *NodePtr;
         NodePtr   left;
         NodePtr   right;
         NodePtr   parent;
         ColorT    color;
+        [[no_unique_address]] count_type cnt;
         data_type data;
 
-        Node(const data_type &_data, ColorT _color)
-            : data(_data), left(nullptr), right(nullptr), parent(nullptr), color(_color) {}
+        // data is constructed in place from args
+        template <class... Args>
+        Node(ColorT _color, Args &&...args)
+            : left(nullptr), right(nullptr), parent(nullptr), color(_color), cnt(), data(std::forward<Args>(args)...) {}
 
         const key_type &key() const { return data.first; }
 
@@ -79,42 +138,100 @@ template <class Key, class Val, class Compare = std::less<Key>> class RBTree {
 
     };
 
-    typedef Node   *NodePtr;
+    static constexpr size_t MIN_SLAB = 16;
+    static constexpr size_t MAX_SLAB = 4096;
+
+    // the first node-sized slot of every slab, the nodes follow it
+    struct slab_header {
+        NodePtr next;
+        size_t  count;
+    };
+    // a removed node waiting in the free list
+    struct free_link {
+        NodePtr next;
+    };
 
     NodePtr m_root;
+    // the minimum / maximum node, nullptr if empty. They stand in for the header node of
+    // std::map: a header would need a node type without data_type, and every parent == nullptr
+    // test (rotations, join / split, iterators) would change, so end() stays nullptr
+    // and --end() reads m_rightmost
+    NodePtr m_leftmost;
+    NodePtr m_rightmost;
     size_t  m_size;
+    [[no_unique_address]] Compare m_comp; // takes no room if Compare is empty
+    [[no_unique_address]] node_allocator m_alloc;
+    NodePtr m_slabs;     // the newest slab, each one links to the previous
+    NodePtr m_free;      // removed nodes
+    NodePtr m_bump;      // the next never-used node of the newest slab
+    size_t  m_bump_left; // never-used nodes left in the newest slab
 
   public:
-    RBTree() : m_root(nullptr), m_size(0) {}
-    ~RBTree() { tree_delete(m_root); }
+    RBTree()
+        : m_root(nullptr), m_leftmost(nullptr), m_rightmost(nullptr), m_size(0), m_comp(), m_alloc(),
+          m_slabs(nullptr), m_free(nullptr), m_bump(nullptr), m_bump_left(0) {}
+    explicit RBTree(const Alloc &alloc)
+        : m_root(nullptr), m_leftmost(nullptr), m_rightmost(nullptr), m_size(0), m_comp(), m_alloc(alloc),
+          m_slabs(nullptr), m_free(nullptr), m_bump(nullptr), m_bump_left(0) {}
+    explicit RBTree(const Compare &comp, const Alloc &alloc = Alloc())
+        : m_root(nullptr), m_leftmost(nullptr), m_rightmost(nullptr), m_size(0), m_comp(comp), m_alloc(alloc),
+          m_slabs(nullptr), m_free(nullptr), m_bump(nullptr), m_bump_left(0) {}
+    ~RBTree() { release_nodes(); }
 
-    RBTree(const RBTree &other) {
+    RBTree(const RBTree &other)
+        : m_comp(other.m_comp), m_alloc(node_traits::select_on_container_copy_construction(other.m_alloc)),
+          m_slabs(nullptr), m_free(nullptr), m_bump(nullptr), m_bump_left(0) {
         tree_copy(m_root, other.m_root);
+        reset_extremes();
         m_size = other.m_size;
     }
 
     size_t size() const { return m_size; }
 
+    Compare key_comp() const { return m_comp; }
+
     bool empty() const { return m_root == nullptr; }
 
+    // the minimum / maximum node in O(1), nullptr if empty
+    NodePtr leftmost() const { return m_leftmost; }
+
+    NodePtr rightmost() const { return m_rightmost; }
+
     void clear() {
-        tree_delete(m_root);
-        m_root = nullptr;
+        release_nodes();
+        m_root = m_leftmost = m_rightmost = nullptr;
         m_size = 0;
     }
 
     RBTree &operator=(const RBTree &other) {
         if (this == &other) return *this;
-        tree_delete(m_root);
+        release_nodes();
+        m_comp = other.m_comp;
         tree_copy(m_root, other.m_root);
+        reset_extremes();
         m_size = other.m_size;
         return *this;
     }
 
     pair<NodePtr, bool> insert(const data_type &data) {
+        return insert_unique(data.first, [&] { return create_node(RED, data); });
+    }
+
+    pair<NodePtr, bool> insert(data_type &&data) {
+        return insert_unique(data.first, [&] { return create_node(RED, std::move(data)); });
+    }
+
+    /**
+     * insert a node with key in a single top-down pass,
+     * make() is called to create the (red) node only if key is not in the tree.
+     * return the node with key and whether it is new.
+     */
+    template <class Make>
+    pair<NodePtr, bool> insert_unique(const key_type &key, Make make) {
         NodePtr t, p, gp;
         if (m_root == nullptr) {
-            m_root = new Node(data, BLACK);
+            m_root = m_leftmost = m_rightmost = make();
+            m_root->color = BLACK;
             m_size = 1;
             return pair<NodePtr, bool>(m_root, true);
         }
@@ -128,14 +245,21 @@ template <class Key, class Val, class Compare = std::less<Key>> class RBTree {
                 }
                 gp = p;
                 p = t;
-                if (Compare()(data.first, t->key())) t = t->left;
-                else if (Compare()(t->key(), data.first)) t = t->right;
+                if (m_comp(key, t->key())) t = t->left;
+                else if (m_comp(t->key(), key)) t = t->right;
                 else return pair<NodePtr, bool>(t, false);
             } else {
-                t = new Node(data, RED);
-                if (Compare()(data.first, p->key())) p->left = t;
+                // key may be moved into the node, decide the side first
+                bool left = m_comp(key, p->key());
+                t = make();
+                if (left) p->left = t;
                 else p->right = t;
                 t->parent = p;
+                if constexpr (ORDER_STATISTICS) {
+                    for (NodePtr x = p; x; x = x->parent) ++x->cnt.n;
+                }
+                if (left && p == m_leftmost) m_leftmost = t;
+                if (!left && p == m_rightmost) m_rightmost = t;
                 insertAdjust(gp, p, t);
                 m_root->color = BLACK;
                 ++m_size;
@@ -144,80 +268,382 @@ template <class Key, class Val, class Compare = std::less<Key>> class RBTree {
         }
     }
 
-    bool remove(const key_type &key) {
-        NodePtr c, p, t; // c: current node, p: parent node, t: brother node
-        key_type del = key;
-        if (m_root == nullptr) return false;
-        if (key_equal(m_root->key(), key) && m_root->left == nullptr
-            && m_root->right == nullptr) {
-            delete m_root;
-            assert(m_size == 1);
-            m_size = 0;
-            m_root = nullptr;
-            return true;
-        }
-        p = c = t = m_root;
-        while (c != nullptr) {
-            removeAdjust(p, c, t, del);
-            if (key_equal(c->key(), del) && c->left && c->right) {
-                NodePtr tmp = c->right;
-                while (tmp->left) tmp = tmp->left;
-                swap(tmp->color, c->color);
-                tmp->left = c->left;
-                c->left = nullptr;
-                if (tmp->left) tmp->left->parent = tmp;
-                if (c->parent) {
-                    if (c->parent->left == c) c->parent->left = tmp;
-                    else c->parent->right = tmp;
-                } else {
-                    m_root = tmp;
-                }
-                NodePtr pc = c->parent;
-                if (tmp->parent != c) {
-                    tmp->parent->left = c;
-                    c->parent = tmp->parent;
-                    swap(c->right, tmp->right);
-                    if (c->right) c->right->parent = c;
-                    if (tmp->right) tmp->right->parent = tmp;
+    /**
+     * construct the data in a new node first, then insert it by its key,
+     * the node is destroyed again if the key is already in the tree.
+     */
+    template <class... Args>
+    pair<NodePtr, bool> emplace(Args &&...args) {
+        NodePtr x = create_node(RED, std::forward<Args>(args)...);
+        try {
+            pair<NodePtr, bool> res = insert_unique(x->key(), [x] { return x; });
+            if (!res.second) destroy_node(x);
+            return res;
+        } catch (...) {
+            destroy_node(x);
+            throw;
+        }
+    }
+
+    /**
+     * insert (key, Val(args...)) built in place, if key is not in the tree.
+     */
+    template <class K, class... Args>
+    pair<NodePtr, bool> try_emplace(K &&key, Args &&...args) {
+        return insert_unique(key, [&] {
+            return create_node(RED, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                               std::forward_as_tuple(std::forward<Args>(args)...));
+        });
+    }
+
+    /**
+     * replace the contents with [first, last) sorted by key, in O(n) without rotations:
+     * the tree is built perfectly balanced, with the deepest, incomplete level red.
+     * of equal keys only the first one is kept, as insert would do.
+     * return false and keep the contents if the range is not sorted.
+     */
+    template <std::forward_iterator It>
+    bool assign_sorted(It first, It last) {
+        size_t n = 0;
+        for (It i = first, prev = first; i != last; prev = i, ++i) {
+            if (i == first || m_comp((*prev).first, (*i).first)) ++n;
+            else if (m_comp((*i).first, (*prev).first)) return false;
+        }
+        clear();
+        // the levels above the deepest one are full
+        build_sorted(m_root, nullptr, first, last, n, 0, std::bit_width(n + 1) - 1);
+        m_size = n;
+        reset_extremes();
+        return true;
+    }
+
+    template <class K>
+    bool remove(const K &key) {
+        NodePtr x = find(key);
+        if (x == nullptr) return false;
+        erase_node(x);
+        return true;
+    }
+
+    /**
+     * remove the node z itself, fixing the colors bottom-up from where it was,
+     * so there is no search and no key is compared or copied.
+     * return the successor of z.
+     */
+    NodePtr erase_node(NodePtr z) {
+        NodePtr next = z->successor();
+        if (z == m_leftmost) m_leftmost = next;
+        if (z == m_rightmost) m_rightmost = z->predecessor();
+        NodePtr y = z, x, xp; // y: the node leaving its place, x: its replacement, xp: parent of x
+        if (!z->left) x = z->right;
+        else if (!z->right) x = z->left;
+        else {
+            y = z->right;
+            while (y->left) y = y->left;
+            x = y->right;
+        }
+        if (y != z) {
+            // y takes the place and the color of z
+            z->left->parent = y;
+            y->left = z->left;
+            if (y != z->right) {
+                xp = y->parent;
+                if (x) x->parent = xp;
+                xp->left = x;
+                y->right = z->right;
+                z->right->parent = y;
+            } else {
+                xp = y;
+            }
+            replace_child(z, y);
+            y->parent = z->parent;
+            swap(y->color, z->color);
+            if constexpr (ORDER_STATISTICS) y->cnt.n = z->cnt.n;
+        } else {
+            xp = z->parent;
+            if (x) x->parent = xp;
+            replace_child(z, x);
+        }
+        if constexpr (ORDER_STATISTICS) {
+            // every node from xp up lost one node below it
+            for (NodePtr a = xp; a; a = a->parent) --a->cnt.n;
+        }
+        // z->color is now the color removed from the tree
+        if (z->color == BLACK) {
+            while (x != m_root && !isRed(x)) {
+                if (x == xp->left) {
+                    NodePtr w = xp->right;
+                    if (isRed(w)) {
+                        w->color = BLACK;
+                        xp->color = RED;
+                        RR(xp);
+                        w = xp->right;
+                    }
+                    if (!isRed(w->left) && !isRed(w->right)) {
+                        w->color = RED;
+                        x = xp;
+                        xp = xp->parent;
+                    } else {
+                        if (!isRed(w->right)) {
+                            w->left->color = BLACK;
+                            w->color = RED;
+                            LL(w);
+                            w = xp->right;
+                        }
+                        w->color = xp->color;
+                        xp->color = BLACK;
+                        w->right->color = BLACK;
+                        RR(xp);
+                        break;
+                    }
                 } else {
-                    c->right = tmp->right;
-                    if (c->right) c->right->parent = c;
-                    c->parent = tmp;
-                    tmp->right = c;
+                    NodePtr w = xp->left;
+                    if (isRed(w)) {
+                        w->color = BLACK;
+                        xp->color = RED;
+                        LL(xp);
+                        w = xp->left;
+                    }
+                    if (!isRed(w->left) && !isRed(w->right)) {
+                        w->color = RED;
+                        x = xp;
+                        xp = xp->parent;
+                    } else {
+                        if (!isRed(w->left)) {
+                            w->right->color = BLACK;
+                            w->color = RED;
+                            RR(w);
+                            w = xp->left;
+                        }
+                        w->color = xp->color;
+                        xp->color = BLACK;
+                        w->left->color = BLACK;
+                        LL(xp);
+                        break;
+                    }
                 }
-                tmp->parent = pc;
-                p = tmp;
-                c = p->right;
-                t = p->left;
-                continue;
-            }
-            if (key_equal(c->key(), del)) {
-                assert(c->left == nullptr && c->right == nullptr);
-                assert(c->parent == p);
-                delete c;
-                --m_size;
-                if (p->left == c) p->left = nullptr;
-                else p->right = nullptr;
-                m_root->color = BLACK;
-                return true;
             }
-            p = c;
-            c = (Compare()(del, c->key())) ? c->left : c->right;
-            t = (c == p->left) ? p->right : p->left;
+            if (x) x->color = BLACK;
         }
-        return false;
+        destroy_node(z);
+        --m_size;
+        return next;
     }
 
-    NodePtr find(const key_type &key) const {
+    template <class K>
+    NodePtr find(const K &key) const {
         NodePtr t = m_root;
         while (t) {
-            if (Compare()(key, t->key())) t = t->left;
-            else if (Compare()(t->key(), key)) t = t->right;
+            if (m_comp(key, t->key())) t = t->left;
+            else if (m_comp(t->key(), key)) t = t->right;
             else break;
         }
         return t;
     }
 
+    // the first node whose key is not less than key, nullptr if there is none
+    template <class K>
+    NodePtr lower_bound(const K &key) const {
+        NodePtr t = m_root, res = nullptr;
+        while (t) {
+            if (m_comp(t->key(), key)) t = t->right;
+            else res = t, t = t->left;
+        }
+        return res;
+    }
+
+    // the first node whose key is greater than key, nullptr if there is none
+    template <class K>
+    NodePtr upper_bound(const K &key) const {
+        NodePtr t = m_root, res = nullptr;
+        while (t) {
+            if (m_comp(key, t->key())) res = t, t = t->left;
+            else t = t->right;
+        }
+        return res;
+    }
+
+    static size_t count_of(NodePtr x) {
+        if constexpr (ORDER_STATISTICS) return x ? x->cnt.n : 0;
+        else return 0;
+    }
+
+    // the node n positions after x (before if n < 0), nullptr is the end.
+    // throw invalid_iterator if that is out of [begin, end]
+    NodePtr advance(NodePtr x, std::ptrdiff_t n) const requires ORDER_STATISTICS {
+        std::ptrdiff_t r = static_cast<std::ptrdiff_t>(rank_of(x)) + n;
+        if (r < 0 || r > static_cast<std::ptrdiff_t>(m_size)) throw invalid_iterator();
+        return select(r);
+    }
+
+    // the node with k smaller keys (0-based), nullptr if k >= size()
+    NodePtr select(size_t k) const requires ORDER_STATISTICS {
+        NodePtr t = m_root;
+        while (t) {
+            size_t ls = count_of(t->left);
+            if (k < ls) t = t->left;
+            else if (k == ls) return t;
+            else k -= ls + 1, t = t->right;
+        }
+        return nullptr;
+    }
+
+    // the number of keys less than key
+    size_t rank(const key_type &key) const requires ORDER_STATISTICS {
+        NodePtr t = m_root;
+        size_t r = 0;
+        while (t) {
+            if (m_comp(t->key(), key)) r += count_of(t->left) + 1, t = t->right;
+            else t = t->left;
+        }
+        return r;
+    }
+
+    // the index of node x in key order, size() for nullptr (the end)
+    size_t rank_of(NodePtr x) const requires ORDER_STATISTICS {
+        if (x == nullptr) return m_size;
+        size_t r = count_of(x->left);
+        for (; x->parent; x = x->parent) {
+            if (x == x->parent->right) r += count_of(x->parent->left) + 1;
+        }
+        return r;
+    }
+
+    /**
+     * join-based set algebra. A subtree is a detached red-black tree with a black
+     * root (or empty) together with its black height, made of nodes of this tree.
+     *
+     * join(l, k, r) links the node k between l and r, where every key of l is less
+     * than k->key() and every key of r is greater, in O(|bh(l) - bh(r)| + 1).
+     * split(t, key) cuts t into the keys less / greater than key and the node
+     * with key itself (nullptr if there is none), in O(log n).
+     * join2(l, r) is join without the middle node, in O(log n).
+     */
+    struct subtree {
+        NodePtr root = nullptr;
+        size_t  black_height = 0;
+    };
+    struct split_type {
+        subtree less;
+        NodePtr mid;
+        subtree greater;
+    };
+    enum set_op { UNION, INTERSECTION, DIFFERENCE };
+
+    subtree join(subtree l, NodePtr k, subtree r) {
+        NodePtr t;
+        size_t h;
+        if (l.black_height > r.black_height) {
+            t = join_right(l.root, l.black_height, k, r);
+            h = l.black_height;
+        } else if (l.black_height < r.black_height) {
+            t = join_left(l, k, r.root, r.black_height);
+            h = r.black_height;
+        } else {
+            k->color = BLACK;
+            link(k, l.root, r.root);
+            t = k;
+            h = l.black_height + 1;
+        }
+        return detach(t, h);
+    }
+
+    split_type split(subtree t, const key_type &key) {
+        if (t.root == nullptr) return {subtree(), nullptr, subtree()};
+        NodePtr x = t.root;
+        subtree l = detach(x->left, t.black_height - 1), r = detach(x->right, t.black_height - 1);
+        if (m_comp(key, x->key())) {
+            split_type s = split(l, key);
+            s.greater = join(s.greater, x, r);
+            return s;
+        }
+        if (m_comp(x->key(), key)) {
+            split_type s = split(r, key);
+            s.less = join(l, x, s.less);
+            return s;
+        }
+        return {l, x, r};
+    }
+
+    subtree join2(subtree l, subtree r) {
+        if (l.root == nullptr) return r;
+        NodePtr last;
+        l = split_last(l, last);
+        return join(l, last, r);
+    }
+
+    /**
+     * replace the tree with the union / intersection / difference of its keys and
+     * the keys of the other tree, in O(m log(n / m + 1)) for sizes m <= n.
+     * other is made of nodes of this tree (see take_tree / copy_tree) and other_size
+     * is its number of nodes. Of equal keys the node of this tree is kept, the other
+     * one is destroyed. With parallel, the two halves of big inputs are combined on
+     * different threads, no two of them touch the same node.
+     */
+    void combine(set_op op, subtree other, size_t other_size, bool parallel) {
+        subtree self = detach(m_root, black_height(m_root));
+        m_root = nullptr;
+        NodePtr garbage = nullptr;
+        int forks = parallel ? std::bit_width(std::thread::hardware_concurrency()) : 0;
+        subtree res = combine(op, self, other, garbage, forks);
+        m_size += other_size;
+        m_size -= destroy_garbage(garbage);
+        m_root = res.root;
+        reset_extremes();
+    }
+
+    // the nodes of other as a subtree of this tree, other is left empty.
+    // the slabs of other are moved into this pool if the allocators are equal, else its nodes are copied
+    subtree take_tree(RBTree &other) {
+        if constexpr (!node_traits::is_always_equal::value) {
+            if (!(m_alloc == other.m_alloc)) {
+                subtree t = copy_tree(other);
+                other.clear();
+                return t;
+            }
+        }
+        subtree t = {other.m_root, black_height(other.m_root)};
+        if (NodePool && other.m_slabs) {
+            NodePtr oldest = other.m_slabs;
+            while (slab_of(oldest)->next) oldest = slab_of(oldest)->next;
+            if (m_slabs) {
+                // behind the newest slab of this tree, which keeps growing,
+                // the never-used nodes of the newest slab of other become free nodes
+                slab_of(oldest)->next = slab_of(m_slabs)->next;
+                slab_of(m_slabs)->next = other.m_slabs;
+                for (NodePtr x = other.m_bump; other.m_bump_left > 0; --other.m_bump_left) {
+                    NodePtr nxt = std::to_address(x) + 1;
+                    give_back(x);
+                    x = nxt;
+                }
+            } else {
+                m_slabs = other.m_slabs;
+                m_bump = other.m_bump;
+                m_bump_left = other.m_bump_left;
+            }
+            // the free list of other goes in front of this one
+            if (other.m_free) {
+                NodePtr tail = other.m_free;
+                while (free_next(tail)) tail = free_next(tail);
+                free_next(tail) = m_free;
+                m_free = other.m_free;
+            }
+        }
+        other.m_root = other.m_leftmost = other.m_rightmost = nullptr;
+        other.m_slabs = other.m_free = other.m_bump = nullptr;
+        other.m_bump_left = 0;
+        other.m_size = 0;
+        return t;
+    }
+
+    // a copy of the nodes of other as a subtree of this tree
+    subtree copy_tree(const RBTree &other) {
+        subtree t;
+        tree_copy(t.root, other.m_root);
+        t.black_height = black_height(t.root);
+        return t;
+    }
+
     void debug(NodePtr x) {
         if (x == nullptr) return;
         if (x->left) {
@@ -273,16 +699,93 @@ template <class Key, class Val, class Compare = std::less<Key>> class RBTree {
 
   private:
 
-    bool key_equal(const key_type &lhs, const key_type &rhs) const {
-        return !(Compare()(lhs, rhs) || Compare()(rhs, lhs));
+    template <class... Args>
+    NodePtr create_node(Args &&...args) {
+        NodePtr x = take_node();
+        try {
+            node_traits::construct(m_alloc, std::to_address(x), std::forward<Args>(args)...);
+        } catch (...) {
+            give_back(x);
+            throw;
+        }
+        return x;
+    }
+
+    void destroy_node(NodePtr x) {
+        node_traits::destroy(m_alloc, std::to_address(x));
+        give_back(x);
+    }
+
+    // raw memory for one node: a removed one, else the next one of the newest slab
+    NodePtr take_node() {
+        if constexpr (!NodePool) return node_traits::allocate(m_alloc, 1);
+        if (m_free) {
+            NodePtr x = m_free;
+            m_free = free_next(x);
+            return x;
+        }
+        if (m_bump_left == 0) {
+            size_t count = MIN_SLAB;
+            if (m_slabs) {
+                count = std::launder(reinterpret_cast<slab_header *>(std::to_address(m_slabs)))->count * 2;
+                if (count > MAX_SLAB) count = MAX_SLAB;
+            }
+            NodePtr slab = node_traits::allocate(m_alloc, count + 1);
+            std::construct_at(reinterpret_cast<slab_header *>(std::to_address(slab)), slab_header{m_slabs, count});
+            m_slabs = slab;
+            m_bump = std::to_address(slab) + 1;
+            m_bump_left = count;
+        }
+        NodePtr x = m_bump;
+        m_bump = std::to_address(x) + 1;
+        --m_bump_left;
+        return x;
+    }
+
+    void give_back(NodePtr x) {
+        if constexpr (!NodePool) {
+            node_traits::deallocate(m_alloc, x, 1);
+            return;
+        }
+        std::construct_at(reinterpret_cast<free_link *>(std::to_address(x)), free_link{m_free});
+        m_free = x;
+    }
+
+    // destroy every element and return all the slabs (or nodes) to the allocator
+    void release_nodes() {
+        if constexpr (!NodePool) {
+            destroy_tree(m_root);
+            return;
+        }
+        if constexpr (!std::is_trivially_destructible_v<data_type>) destroy_tree(m_root);
+        while (m_slabs) {
+            NodePtr slab = m_slabs;
+            slab_header *h = std::launder(reinterpret_cast<slab_header *>(std::to_address(slab)));
+            m_slabs = h->next;
+            node_traits::deallocate(m_alloc, slab, h->count + 1);
+        }
+        m_free = m_bump = nullptr;
+        m_bump_left = 0;
     }
 
-    void tree_delete(NodePtr x) {
+    void destroy_tree(NodePtr x) {
         if (x == nullptr) return;
-        tree_delete(x->left);
-        tree_delete(x->right);
-        delete x;
-        x = nullptr;
+        destroy_tree(x->left);
+        destroy_tree(x->right);
+        node_traits::destroy(m_alloc, std::to_address(x));
+        if constexpr (!NodePool) node_traits::deallocate(m_alloc, x, 1);
+    }
+
+    // put n where z hangs in the tree
+    void replace_child(NodePtr z, NodePtr n) {
+        if (!z->parent) m_root = n;
+        else if (z->parent->left == z) z->parent->left = n;
+        else z->parent->right = n;
+    }
+
+    void reset_extremes() {
+        m_leftmost = m_root ? m_root->minimum() : nullptr;
+        m_rightmost = m_root ? m_root->maximum() : nullptr;
     }
 
     void tree_copy(NodePtr &dest, NodePtr src) {
@@ -290,13 +793,218 @@ template <class Key, class Val, class Compare = std::less<Key>> class RBTree {
             dest = nullptr;
             return;
         }
-        dest = new Node(src->data, src->color);
+        dest = create_node(src->color, src->data);
+        if constexpr (ORDER_STATISTICS) dest->cnt.n = src->cnt.n;
         tree_copy(dest->left, src->left);
         tree_copy(dest->right, src->right);
         if (dest->left) dest->left->parent = dest;
         if (dest->right) dest->right->parent = dest;
     }
 
+    // build a tree of the next n distinct keys from it, the nodes at red_depth are red
+    template <class It>
+    void build_sorted(NodePtr &dest, NodePtr parent, It &it, It last, size_t n, size_t depth, size_t red_depth) {
+        if (n == 0) {
+            dest = nullptr;
+            return;
+        }
+        NodePtr l;
+        build_sorted(l, nullptr, it, last, (n - 1) / 2, depth + 1, red_depth);
+        dest = create_node(depth == red_depth ? RED : BLACK, *it);
+        dest->parent = parent;
+        dest->left = l;
+        if (l) l->parent = dest;
+        if constexpr (ORDER_STATISTICS) dest->cnt.n = n;
+        for (It cur = it++; it != last && !m_comp((*cur).first, (*it).first); ++it);
+        build_sorted(dest->right, dest, it, last, n - 1 - (n - 1) / 2, depth + 1, red_depth);
+    }
+
+    static constexpr size_t PARALLEL_BLACK_HEIGHT = 10; // fork only for at least 2^10 - 1 nodes
+
+    static size_t black_height(NodePtr x) {
+        size_t h = 0;
+        for (; x; x = x->left) h += x->color == BLACK;
+        return h;
+    }
+
+    slab_header *slab_of(NodePtr slab) {
+        return std::launder(reinterpret_cast<slab_header *>(std::to_address(slab)));
+    }
+
+    NodePtr &free_next(NodePtr x) {
+        return std::launder(reinterpret_cast<free_link *>(std::to_address(x)))->next;
+    }
+
+    // make x the root of a subtree, black, h is its black height as a child
+    subtree detach(NodePtr x, size_t h) {
+        if (x == nullptr) return subtree();
+        x->parent = nullptr;
+        if (x->color == RED) x->color = BLACK, ++h;
+        return {x, h};
+    }
+
+    void link(NodePtr k, NodePtr l, NodePtr r) {
+        k->left = l;
+        k->right = r;
+        if (l) l->parent = k;
+        if (r) r->parent = k;
+        pull(k);
+    }
+
+    // hang r with k down the right spine of t at the black height of r,
+    // a red root with a red right child is left for the caller
+    NodePtr join_right(NodePtr t, size_t h, NodePtr k, subtree r) {
+        if (h == r.black_height && !isRed(t)) {
+            k->color = RED;
+            link(k, t, r.root);
+            return k;
+        }
+        NodePtr c = join_right(t->right, h - (t->color == BLACK), k, r);
+        t->right = c;
+        c->parent = t;
+        pull(t);
+        if (t->color == BLACK && isRed(c) && isRed(c->right)) {
+            c->right->color = BLACK;
+            t->right = c->left;
+            if (c->left) c->left->parent = t;
+            pull(t);
+            link(c, t, c->right);
+            return c;
+        }
+        return t;
+    }
+
+    NodePtr join_left(subtree l, NodePtr k, NodePtr t, size_t h) {
+        if (h == l.black_height && !isRed(t)) {
+            k->color = RED;
+            link(k, l.root, t);
+            return k;
+        }
+        NodePtr c = join_left(l, k, t->left, h - (t->color == BLACK));
+        t->left = c;
+        c->parent = t;
+        pull(t);
+        if (t->color == BLACK && isRed(c) && isRed(c->left)) {
+            c->left->color = BLACK;
+            t->left = c->right;
+            if (c->right) c->right->parent = t;
+            pull(t);
+            link(c, c->left, t);
+            return c;
+        }
+        return t;
+    }
+
+    // remove the maximum node of t into last
+    subtree split_last(subtree t, NodePtr &last) {
+        NodePtr x = t.root;
+        subtree l = detach(x->left, t.black_height - 1), r = detach(x->right, t.black_height - 1);
+        if (r.root == nullptr) {
+            last = x;
+            return l;
+        }
+        r = split_last(r, last);
+        return join(l, x, r);
+    }
+
+    // the nodes to destroy are chained through the parent of each subtree root
+    static void discard(NodePtr x, NodePtr &garbage) {
+        if (x == nullptr) return;
+        x->parent = garbage;
+        garbage = x;
+    }
+
+    static void discard_node(NodePtr x, NodePtr &garbage) {
+        x->left = x->right = nullptr;
+        discard(x, garbage);
+    }
+
+    size_t destroy_garbage(NodePtr garbage) {
+        size_t n = 0;
+        while (garbage) {
+            NodePtr next = garbage->parent;
+            n += destroy_subtree(garbage);
+            garbage = next;
+        }
+        return n;
+    }
+
+    size_t destroy_subtree(NodePtr x) {
+        if (x == nullptr) return 0;
+        size_t n = destroy_subtree(x->left) + destroy_subtree(x->right) + 1;
+        destroy_node(x);
+        return n;
+    }
+
+    // a is the tree kept on equal keys, the recursion is on the root of a (b for DIFFERENCE)
+    subtree combine(set_op op, subtree a, subtree b, NodePtr &garbage, int forks) {
+        if (a.root == nullptr || b.root == nullptr) {
+            if (op == UNION) return a.root ? a : b;
+            if (op == DIFFERENCE) {
+                discard(b.root, garbage);
+                return a;
+            }
+            discard(a.root, garbage);
+            discard(b.root, garbage);
+            return subtree();
+        }
+        NodePtr k = op == DIFFERENCE ? b.root : a.root;
+        subtree kt = op == DIFFERENCE ? b : a;
+        subtree kl = detach(k->left, kt.black_height - 1), kr = detach(k->right, kt.black_height - 1);
+        split_type s = split(op == DIFFERENCE ? a : b, k->key());
+        subtree l, r;
+        if (op == DIFFERENCE) {
+            // keys less / greater than k, with the node of k kept aside
+            NodePtr g = nullptr;
+            auto left = [&] { l = combine(op, s.less, kl, g, forks - 1); };
+            auto right = [&] { r = combine(op, s.greater, kr, garbage, forks - 1); };
+            fork_join(forks > 0 && kt.black_height >= PARALLEL_BLACK_HEIGHT, left, right);
+            chain(garbage, g);
+            if (s.mid) discard_node(s.mid, garbage);
+            discard_node(k, garbage);
+            return join2(l, r);
+        }
+        NodePtr g = nullptr;
+        auto left = [&] { l = combine(op, kl, s.less, g, forks - 1); };
+        auto right = [&] { r = combine(op, kr, s.greater, garbage, forks - 1); };
+        fork_join(forks > 0 && kt.black_height >= PARALLEL_BLACK_HEIGHT, left, right);
+        chain(garbage, g);
+        if (op == UNION || s.mid) {
+            if (s.mid) discard_node(s.mid, garbage);
+            return join(l, k, r);
+        }
+        discard_node(k, garbage);
+        return join2(l, r);
+    }
+
+    // run left on another thread while right runs on this one if fork is set
+    template <class L, class R>
+    static void fork_join(bool fork, L &left, R &right) {
+        if (fork) {
+            std::future<void> f;
+            try {
+                f = std::async(std::launch::async, left);
+            } catch (const std::system_error &) {
+                fork = false; // no thread available
+            }
+            if (fork) {
+                right();
+                f.get();
+                return;
+            }
+        }
+        left();
+        right();
+    }
+
+    // put the garbage chain g in front of garbage
+    static void chain(NodePtr &garbage, NodePtr g) {
+        if (g == nullptr) return;
+        NodePtr tail = g;
+        while (tail->parent) tail = tail->parent;
+        tail->parent = garbage;
+        garbage = g;
+    }
 
     void LL(NodePtr gp) {
         NodePtr p = gp->left;
@@ -311,6 +1019,8 @@ template <class Key, class Val, class Compare = std::less<Key>> class RBTree {
             m_root = p;
         }
         gp->parent = p;
+        pull(gp);
+        pull(p);
     }
 
     void RR(NodePtr gp) {
@@ -326,6 +1036,8 @@ template <class Key, class Val, class Compare = std::less<Key>> class RBTree {
             m_root = p;
         }
         gp->parent = p;
+        pull(gp);
+        pull(p);
     }
 
     void LR(NodePtr gp) {
@@ -338,6 +1050,11 @@ template <class Key, class Val, class Compare = std::less<Key>> class RBTree {
         RR(gp);
     }
 
+    // recompute the subtree size of x from its children
+    void pull(NodePtr x) {
+        if constexpr (ORDER_STATISTICS) x->cnt.n = count_of(x->left) + count_of(x->right) + 1;
+    }
+
     inline bool isBlack(NodePtr x) {
         return x && x->color == BLACK;
     }
@@ -362,95 +1079,58 @@ template <class Key, class Val, class Compare = std::less<Key>> class RBTree {
             else RL(gp), swap(t->color, gp->color);
         }
     }
+};
 
-    void removeAdjust(NodePtr &p, NodePtr &c, NodePtr &t, key_type del) {
-        if (isRed(c)) return;
-        if (c == m_root) {
-            if (c->left && c->right && c->left->color == c->right->color) {
-                c->color = RED;
-                c->left->color = c->right->color = BLACK;
-                return ;
-            }
-        }
-        if (!isRed(c->left) && !isRed(c->right)) {
-            if (!isRed(t->left) && !isRed(t->right)) {
-                p->color = BLACK;
-                c->color = t->color = RED;
-            } else {
-                if (p->left == t) {
-                    if (isRed(t->left)) {
-                        t->left->color = BLACK;
-                        p->color = BLACK;
-                        t->color = RED;
-                        LL(p);
-                    } else {
-                        p->color = BLACK;
-                        LR(p);
-                    }
-                } else {
-                    if (isRed(t->right)) {
-                        t->right->color = BLACK;
-                        p->color = BLACK;
-                        t->color = RED;
-                        RR(p);
-                    } else {
-                        p->color = BLACK;
-                        RL(p);
-                    }
-                }
-                c->color = RED;
-            }
-        } else {
-            if (key_equal(c->key(), del)) {
-                if (c->left && c->right) {
-                    if (c->right->color == BLACK) {
-                        c->left->color = BLACK;
-                        c->color = RED;
-                        p = c->left;
-                        LL(c);
-                    }
-                    return ;
-                }
-                if (c->left) {
-                    assert(isRed(c->left));
-                    c->left->color = BLACK;
-                    c->color = RED;
-                    p = c->left;
-                    LL(c);
-                } else {
-                    assert(isRed(c->right));
-                    c->right->color = BLACK;
-                    c->color = RED;
-                    p = c->right;
-                    RR(c);
-                }
-            } else {
-                p = c;
-                c = (Compare()(del, p->key())) ? p->left : p->right;
-                t = (c == p->left) ? p->right : p->left;
-                if (c->color == BLACK) {
-                    assert(isRed(t));
-                    t->color = BLACK, p->color = RED;
-                    if (t == p->right) RR(p);
-                    else LL(p);
-                    t = (c == p->left) ? p->right : p->left;
-                    removeAdjust(p, c, t, del);
-                }
-            }
-        }
+struct map_iterator_tag : std::bidirectional_iterator_tag {};
+
+/**
+ * lazy range adaptors, e.g.
+ *   for (auto &v : m | sjtu::views::values | sjtu::views::filter(pred)) ...
+ * nothing is copied, the elements are produced while iterating.
+ */
+namespace views {
+
+namespace detail {
+
+// the member of a pair, by reference if the pair is an lvalue, by value otherwise
+template <int I>
+struct pair_member {
+    template <class P>
+    constexpr decltype(auto) operator()(P &&p) const {
+        auto &m = [&]() -> auto & { if constexpr (I == 0) return p.first; else return p.second; }();
+        if constexpr (std::is_lvalue_reference_v<P>) return (m);
+        else return std::remove_cvref_t<decltype(m)>(std::move(m));
     }
 };
 
-struct map_iterator_tag : std::bidirectional_iterator_tag {};
+} // namespace detail
+
+// the keys / mapped values of a range of pairs, like std::views::keys / values
+inline constexpr auto keys = std::views::transform(detail::pair_member<0>());
+inline constexpr auto values = std::views::transform(detail::pair_member<1>());
+
+using std::views::all;
+using std::views::drop;
+using std::views::drop_while;
+using std::views::filter;
+using std::views::reverse;
+using std::views::take;
+using std::views::take_while;
+using std::views::transform;
+
+} // namespace views
 
 
 template <
     class Key,
     class T,
-    class Compare = std::less<Key>
-    > class map : public RBTree<Key, T, Compare> {
+    class Compare = std::less<Key>,
+    class Alloc = std::allocator<pair<const Key, T>>,
+    class Policy = null_node_update,
+    bool NodePool = true
+    > class map : public RBTree<Key, T, Compare, Alloc, Policy, NodePool> {
   private:
-    using Node = typename RBTree<Key, T, Compare>::Node;
+    using Node = typename RBTree<Key, T, Compare, Alloc, Policy, NodePool>::Node;
     using NodePtr = Node*;
     using ConstNodePtr = const Node*;
   public:
@@ -459,7 +1139,23 @@ template <
      * it should have a default constructor, a copy constructor.
      * You can use sjtu::map as value_type by typedef.
      */
-    using value_type = typename RBTree<Key, T, Compare>::data_type;
+    using value_type = typename RBTree<Key, T, Compare, Alloc, Policy, NodePool>::data_type;
+    using allocator_type = Alloc;
+    using key_compare = Compare;
+
+    /**
+     * compares two elements by their keys with the comparator of the map.
+     */
+    class value_compare {
+        friend map;
+      protected:
+        Compare comp;
+        value_compare(const Compare &c) : comp(c) {}
+      public:
+        bool operator()(const value_type &lhs, const value_type &rhs) const {
+            return comp(lhs.first, rhs.first);
+        }
+    };
 
 
     /**
@@ -478,7 +1174,7 @@ template <
 
       public:
         using difference_type = std::ptrdiff_t;
-        using value_type = typename RBTree<Key, T, Compare>::data_type;
+        using value_type = typename RBTree<Key, T, Compare, Alloc, Policy, NodePool>::data_type;
         using iterator_category = map_iterator_tag;
         using pointer = value_type *;
         using reference = value_type &;
@@ -486,6 +1182,7 @@ template <
         iterator() : ptr(nullptr), mp(nullptr) {}
         iterator(NodePtr _ptr, const map *_mp) : ptr(_ptr), mp(_mp) {}
         iterator(const iterator &other) : ptr(other.ptr), mp(other.mp) {}
+        iterator &operator=(const iterator &other) = default;
 
         iterator operator++(int) {
             auto tmp = *this;
@@ -508,7 +1205,7 @@ template <
         iterator &operator--() {
             if (ptr == nullptr) {
                 if (mp->m_root == nullptr) throw invalid_iterator();
-                ptr = mp->m_root->maximum();
+                ptr = mp->m_rightmost;
             } else {
                 auto tmp = ptr->predecessor();
                 if (tmp == nullptr) throw invalid_iterator();
@@ -516,6 +1213,29 @@ template <
             }
             return *this;
         }
+        /**
+         * O(log n) jumps and distances, only with order_statistics_node_update.
+         * throw invalid_iterator if the result is out of [begin, end]
+         */
+        iterator &operator+=(difference_type n) requires map::ORDER_STATISTICS {
+            ptr = mp->advance(ptr, n);
+            return *this;
+        }
+        iterator &operator-=(difference_type n) requires map::ORDER_STATISTICS {
+            ptr = mp->advance(ptr, -n);
+            return *this;
+        }
+        iterator operator+(difference_type n) const requires map::ORDER_STATISTICS {
+            auto tmp = *this;
+            return tmp += n;
+        }
+        iterator operator-(difference_type n) const requires map::ORDER_STATISTICS {
+            auto tmp = *this;
+            return tmp -= n;
+        }
+        difference_type operator-(const iterator &rhs) const requires map::ORDER_STATISTICS {
+            return static_cast<difference_type>(mp->rank_of(ptr)) - static_cast<difference_type>(mp->rank_of(rhs.ptr));
+        }
         /**
          * a operator to check whether two iterators are same (pointing to the same memory).
          */
@@ -550,7 +1270,7 @@ template <
         const map *mp;
       public:
         using difference_type = std::ptrdiff_t;
-        using value_type = typename RBTree<Key, T, Compare>::data_type;
+        using value_type = typename RBTree<Key, T, Compare, Alloc, Policy, NodePool>::data_type;
         using iterator_category = map_iterator_tag;
         using pointer = const value_type *;
         using reference = const value_type &;
@@ -559,6 +1279,7 @@ template <
         const_iterator(NodePtr _ptr, const map *_mp) : ptr(_ptr), mp(_mp) {}
         const_iterator(const const_iterator &other) : ptr(other.ptr), mp(other.mp) {}
         const_iterator(const iterator &other) : ptr(other.ptr), mp(other.mp) {}
+        const_iterator &operator=(const const_iterator &other) = default;
 
         const_iterator operator++(int) {
             auto tmp = *this;
@@ -581,7 +1302,7 @@ template <
         const_iterator &operator--() {
             if (ptr == nullptr) {
                 if (mp->m_root == nullptr) throw invalid_iterator();
-                ptr = mp->m_root->maximum();
+                ptr = mp->m_rightmost;
             } else {
                 auto tmp = ptr->predecessor();
                 if (tmp == nullptr) throw invalid_iterator();
@@ -589,6 +1310,29 @@ template <
             }
             return *this;
         }
+        /**
+         * O(log n) jumps and distances, only with order_statistics_node_update.
+         * throw invalid_iterator if the result is out of [begin, end]
+         */
+        const_iterator &operator+=(difference_type n) requires map::ORDER_STATISTICS {
+            ptr = mp->advance(ptr, n);
+            return *this;
+        }
+        const_iterator &operator-=(difference_type n) requires map::ORDER_STATISTICS {
+            ptr = mp->advance(ptr, -n);
+            return *this;
+        }
+        const_iterator operator+(difference_type n) const requires map::ORDER_STATISTICS {
+            auto tmp = *this;
+            return tmp += n;
+        }
+        const_iterator operator-(difference_type n) const requires map::ORDER_STATISTICS {
+            auto tmp = *this;
+            return tmp -= n;
+        }
+        difference_type operator-(const const_iterator &rhs) const requires map::ORDER_STATISTICS {
+            return static_cast<difference_type>(mp->rank_of(ptr)) - static_cast<difference_type>(mp->rank_of(rhs.ptr));
+        }
         /**
          * a operator to check whether two iterators are same (pointing to the same memory).
          */
@@ -618,14 +1362,34 @@ template <
     /**
      * TODO two constructors
      */
-    map() : RBTree<Key, T, Compare>() {}
-    map(const map &other) : RBTree<Key, T, Compare>(other) {}
+    map() : RBTree<Key, T, Compare, Alloc, Policy, NodePool>() {}
+    explicit map(const Alloc &alloc) : RBTree<Key, T, Compare, Alloc, Policy, NodePool>(alloc) {}
+    /**
+     * the comparator is stored and used for every comparison,
+     *   so it may carry state and need not be default constructible.
+     */
+    explicit map(const Compare &comp, const Alloc &alloc = Alloc())
+        : RBTree<Key, T, Compare, Alloc, Policy, NodePool>(comp, alloc) {}
+    map(const map &other) : RBTree<Key, T, Compare, Alloc, Policy, NodePool>(other) {}
+    /**
+     * construct from the elements of [first, last), the first of equal keys is kept.
+     * a sorted forward range is detected with n - 1 comparisons and built in O(n),
+     * otherwise the elements are inserted one by one.
+     */
+    template <std::input_iterator It>
+    map(It first, It last, const Compare &comp = Compare(), const Alloc &alloc = Alloc())
+        : RBTree<Key, T, Compare, Alloc, Policy, NodePool>(comp, alloc) {
+        if constexpr (std::forward_iterator<It>) {
+            if (RBTree<Key, T, Compare, Alloc, Policy, NodePool>::assign_sorted(first, last)) return;
+        }
+        for (; first != last; ++first) RBTree<Key, T, Compare, Alloc, Policy, NodePool>::emplace(*first);
+    }
     /**
      * TODO assignment operator
      */
     map &operator=(const map &other) {
         if (this == &other) return *this;
-        RBTree<Key, T, Compare>::operator=(other);
+        RBTree<Key, T, Compare, Alloc, Policy, NodePool>::operator=(other);
         return *this;
     }
     /**
@@ -639,12 +1403,24 @@ template <
      * If no such element exists, an exception of type `index_out_of_bound'
      */
     T &at(const Key &key) {
-        NodePtr tmp = RBTree<Key, T, Compare>::find(key);
+        NodePtr tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key);
         if (tmp == nullptr) throw index_out_of_bound();
         return tmp->data.second;
     }
     const T &at(const Key &key) const {
-        NodePtr tmp = RBTree<Key, T, Compare>::find(key);
+        NodePtr tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key);
+        if (tmp == nullptr) throw index_out_of_bound();
+        return tmp->data.second;
+    }
+    template <class K> requires transparent_compare<Compare>
+    T &at(const K &key) {
+        NodePtr tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key);
+        if (tmp == nullptr) throw index_out_of_bound();
+        return tmp->data.second;
+    }
+    template <class K> requires transparent_compare<Compare>
+    const T &at(const K &key) const {
+        NodePtr tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key);
         if (tmp == nullptr) throw index_out_of_bound();
         return tmp->data.second;
     }
@@ -655,17 +1431,16 @@ template <
      *   performing an insertion if such key does not already exist.
      */
     T &operator[](const Key &key) {
-        NodePtr tmp = RBTree<Key, T, Compare>::find(key);
-        if (tmp == nullptr) {
-            return RBTree<Key, T, Compare>::insert({key, T()}).first->data.second;
-        }
-        return tmp->data.second;
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::try_emplace(key).first->data.second;
+    }
+    T &operator[](Key &&key) {
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::try_emplace(std::move(key)).first->data.second;
     }
     /**
      * behave like at() throw index_out_of_bound if such key does not exist.
      */
     const T &operator[](const Key &key) const {
-        NodePtr tmp = RBTree<Key, T, Compare>::find(key);
+        NodePtr tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key);
         if (tmp == nullptr) throw index_out_of_bound();
         return tmp->data.second;
     }
@@ -673,16 +1448,13 @@ template <
      * return a iterator to the beginning
      */
     iterator begin() {
-        return iterator(RBTree<Key, T, Compare>::m_root ?
-                        RBTree<Key, T, Compare>::m_root->minimum() : nullptr, this);
+        return iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::leftmost(), this);
     }
     const_iterator begin() const {
-        return const_iterator(RBTree<Key, T, Compare>::m_root ?
-                              RBTree<Key, T, Compare>::m_root->minimum() : nullptr, this);
+        return const_iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::leftmost(), this);
     }
     const_iterator cbegin() const {
-        return const_iterator(RBTree<Key, T, Compare>::m_root ?
-                              RBTree<Key, T, Compare>::m_root->minimum() : nullptr, this);
+        return const_iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::leftmost(), this);
     }
     /**
      * return a iterator to the end
@@ -697,24 +1469,48 @@ template <
     const_iterator cend() const {
         return const_iterator(nullptr, this);
     }
+    /**
+     * reverse iterators, rbegin() points to the largest key.
+     * begin(), rbegin() and --end() are O(1), the tree keeps its extreme nodes.
+     */
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator crbegin() const {
+        return const_reverse_iterator(cend());
+    }
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+    const_reverse_iterator crend() const {
+        return const_reverse_iterator(cbegin());
+    }
     /**
      * checks whether the container is empty
      * return true if empty, otherwise false.
      */
     bool empty() const {
-        return RBTree<Key, T, Compare>::empty();
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::empty();
     }
     /**
      * returns the number of elements.
      */
     size_t size() const {
-        return RBTree<Key, T, Compare>::size();
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::size();
     }
     /**
      * clears the contents
      */
     void clear() {
-        RBTree<Key, T, Compare>::clear();
+        RBTree<Key, T, Compare, Alloc, Policy, NodePool>::clear();
     }
     /**
      * insert an element.
@@ -723,17 +1519,135 @@ template <
      *   the second one is true if insert successfully, or false.
      */
     pair<iterator, bool> insert(const value_type &value) {
-        auto tmp = RBTree<Key, T, Compare>::insert(value);
+        auto tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::insert(value);
+        return pair<iterator, bool>(iterator(tmp.first, this), tmp.second);
+    }
+    pair<iterator, bool> insert(value_type &&value) {
+        auto tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::insert(std::move(value));
+        return pair<iterator, bool>(iterator(tmp.first, this), tmp.second);
+    }
+    /**
+     * construct a value_type from args in a new node and insert it.
+     * the node is dropped if its key already exists.
+     * return a pair like insert().
+     */
+    template <class... Args>
+    pair<iterator, bool> emplace(Args &&...args) {
+        auto tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::emplace(std::forward<Args>(args)...);
+        return pair<iterator, bool>(iterator(tmp.first, this), tmp.second);
+    }
+    /**
+     * if key does not exist, insert (key, T(args...)) constructed in place,
+     *   otherwise nothing happens and args are not touched.
+     * return a pair like insert().
+     */
+    template <class... Args>
+    pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+        auto tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::try_emplace(key, std::forward<Args>(args)...);
         return pair<iterator, bool>(iterator(tmp.first, this), tmp.second);
     }
+    template <class... Args>
+    pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+        auto tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::try_emplace(std::move(key), std::forward<Args>(args)...);
+        return pair<iterator, bool>(iterator(tmp.first, this), tmp.second);
+    }
+    /**
+     * insert (key, obj) if key does not exist, otherwise assign obj to its value.
+     * return a pair like insert(), the second is false if it was assigned.
+     */
+    template <class M>
+    pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+        auto tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::try_emplace(key, std::forward<M>(obj));
+        if (!tmp.second) tmp.first->data.second = std::forward<M>(obj);
+        return pair<iterator, bool>(iterator(tmp.first, this), tmp.second);
+    }
+    template <class M>
+    pair<iterator, bool> insert_or_assign(Key &&key, M &&obj) {
+        auto tmp = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::try_emplace(std::move(key), std::forward<M>(obj));
+        if (!tmp.second) tmp.first->data.second = std::forward<M>(obj);
+        return pair<iterator, bool>(iterator(tmp.first, this), tmp.second);
+    }
+    /**
+     * replace the contents with [first, last), which should be sorted by key,
+     * in O(n). An unsorted range is inserted one by one instead.
+     */
+    template <std::forward_iterator It>
+    void assign_sorted(It first, It last) {
+        if (RBTree<Key, T, Compare, Alloc, Policy, NodePool>::assign_sorted(first, last)) return;
+        clear();
+        for (; first != last; ++first) RBTree<Key, T, Compare, Alloc, Policy, NodePool>::emplace(*first);
+    }
     /**
-     * erase the element at pos.
+     * set algebra on the keys by splitting and joining the two trees, in
+     * O(m log(n / m + 1)) for sizes m <= n, instead of m inserts / erases.
+     * of equal keys the element of *this is kept.
+     * the map && overloads and merge take the nodes of other, which is left empty,
+     * the const map & overloads work on a copy of other, O(other.size()) more.
+     * with parallel, the two halves of big inputs are done on different threads.
+     *
+     * set_union: *this gets the elements of other with new keys.
+     * set_intersection: the elements of *this whose key is not in other are erased.
+     * set_difference: the elements of *this whose key is in other are erased.
+     */
+    void merge(map &other, bool parallel = false) {
+        set_union(std::move(other), parallel);
+    }
+    void set_union(map &&other, bool parallel = false) {
+        if (&other == this) return;
+        combine_with(UNION, std::move(other), parallel);
+    }
+    void set_union(const map &other, bool parallel = false) {
+        if (&other == this) return;
+        combine_with(UNION, other, parallel);
+    }
+    void set_intersection(map &&other, bool parallel = false) {
+        if (&other == this) return;
+        combine_with(INTERSECTION, std::move(other), parallel);
+    }
+    void set_intersection(const map &other, bool parallel = false) {
+        if (&other == this) return;
+        combine_with(INTERSECTION, other, parallel);
+    }
+    void set_difference(map &&other, bool parallel = false) {
+        if (&other == this) {
+            clear();
+            return;
+        }
+        combine_with(DIFFERENCE, std::move(other), parallel);
+    }
+    void set_difference(const map &other, bool parallel = false) {
+        if (&other == this) {
+            clear();
+            return;
+        }
+        combine_with(DIFFERENCE, other, parallel);
+    }
+    /**
+     * erase the element at pos, starting from its node (no search).
+     * return an iterator to the element after it.
      *
      * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
      */
-    void erase(iterator pos) {
+    iterator erase(iterator pos) {
         if (pos.mp != this || pos == end()) throw invalid_iterator();
-        RBTree<Key, T, Compare>::remove(pos.ptr->key());
+        return iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::erase_node(pos.ptr), this);
+    }
+    iterator erase(const_iterator pos) {
+        if (pos.mp != this || pos == cend()) throw invalid_iterator();
+        return iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::erase_node(pos.ptr), this);
+    }
+    /**
+     * erase the element with key if there is one.
+     * return the number of elements erased (0 or 1).
+     */
+    size_t erase(const Key &key) {
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::remove(key) ? 1 : 0;
+    }
+    template <class K>
+        requires transparent_compare<Compare> && (!std::is_convertible_v<K, iterator>) &&
+                 (!std::is_convertible_v<K, const_iterator>)
+    size_t erase(const K &key) {
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::remove(key) ? 1 : 0;
     }
     /**
      * Returns the number of elements with key
@@ -743,7 +1657,21 @@ template <
      * The default method of check the equivalence is !(a < b || b > a)
      */
     size_t count(const Key &key) const {
-        return RBTree<Key, T, Compare>::find(key) == nullptr ? 0 : 1;
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key) == nullptr ? 0 : 1;
+    }
+    template <class K> requires transparent_compare<Compare>
+    size_t count(const K &key) const {
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key) == nullptr ? 0 : 1;
+    }
+    /**
+     * checks whether there is an element with key equivalent to key.
+     */
+    bool contains(const Key &key) const {
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key) != nullptr;
+    }
+    template <class K> requires transparent_compare<Compare>
+    bool contains(const K &key) const {
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key) != nullptr;
     }
     /**
      * Finds an element with key equivalent to key.
@@ -752,14 +1680,146 @@ template <
      *   If no such element is found, past-the-end (see end()) iterator is returned.
      */
     iterator find(const Key &key) {
-        return iterator(RBTree<Key, T, Compare>::find(key), this);
+        return iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key), this);
     }
     const_iterator find(const Key &key) const {
-        return const_iterator(RBTree<Key, T, Compare>::find(key), this);
+        return const_iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key), this);
+    }
+    template <class K> requires transparent_compare<Compare>
+    iterator find(const K &key) {
+        return iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key), this);
+    }
+    template <class K> requires transparent_compare<Compare>
+    const_iterator find(const K &key) const {
+        return const_iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::find(key), this);
+    }
+    /**
+     * the first element whose key is not less than key / greater than key,
+     *   past-the-end if there is none. Each one is a single descent.
+     */
+    iterator lower_bound(const Key &key) {
+        return iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::lower_bound(key), this);
+    }
+    const_iterator lower_bound(const Key &key) const {
+        return const_iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::lower_bound(key), this);
+    }
+    template <class K> requires transparent_compare<Compare>
+    iterator lower_bound(const K &key) {
+        return iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::lower_bound(key), this);
+    }
+    template <class K> requires transparent_compare<Compare>
+    const_iterator lower_bound(const K &key) const {
+        return const_iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::lower_bound(key), this);
+    }
+    iterator upper_bound(const Key &key) {
+        return iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::upper_bound(key), this);
+    }
+    const_iterator upper_bound(const Key &key) const {
+        return const_iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::upper_bound(key), this);
+    }
+    template <class K> requires transparent_compare<Compare>
+    iterator upper_bound(const K &key) {
+        return iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::upper_bound(key), this);
+    }
+    template <class K> requires transparent_compare<Compare>
+    const_iterator upper_bound(const K &key) const {
+        return const_iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::upper_bound(key), this);
+    }
+    /**
+     * the elements with key equivalent to key, [lower_bound(key), upper_bound(key)).
+     */
+    pair<iterator, iterator> equal_range(const Key &key) {
+        return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+    pair<const_iterator, const_iterator> equal_range(const Key &key) const {
+        return pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+    }
+    template <class K> requires transparent_compare<Compare>
+    pair<iterator, iterator> equal_range(const K &key) {
+        return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+    template <class K> requires transparent_compare<Compare>
+    pair<const_iterator, const_iterator> equal_range(const K &key) const {
+        return pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+    }
+    /**
+     * a view of the elements with lo <= key < hi in ascending order, e.g.
+     *   for (auto &[k, v] : m.range(from, to)) ...
+     * it costs O(log n) to create and O(1) per element.
+     */
+    auto range(const Key &lo, const Key &hi) {
+        iterator first = lower_bound(lo), last = lower_bound(hi);
+        if (RBTree<Key, T, Compare, Alloc, Policy, NodePool>::m_comp(hi, lo)) last = first;
+        return std::ranges::subrange<iterator>(first, last);
+    }
+    auto range(const Key &lo, const Key &hi) const {
+        const_iterator first = lower_bound(lo), last = lower_bound(hi);
+        if (RBTree<Key, T, Compare, Alloc, Policy, NodePool>::m_comp(hi, lo)) last = first;
+        return std::ranges::subrange<const_iterator>(first, last);
+    }
+
+    /**
+     * order statistics, O(log n), only with order_statistics_node_update:
+     *   select(k) is the element with k smaller keys (end if k >= size),
+     *   rank(key) is the number of keys less than key,
+     *   count_range(lo, hi) is the number of keys in [lo, hi).
+     */
+    iterator select(size_t k) requires map::ORDER_STATISTICS {
+        return iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::select(k), this);
+    }
+    const_iterator select(size_t k) const requires map::ORDER_STATISTICS {
+        return const_iterator(RBTree<Key, T, Compare, Alloc, Policy, NodePool>::select(k), this);
+    }
+    size_t rank(const Key &key) const requires map::ORDER_STATISTICS {
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::rank(key);
+    }
+    size_t count_range(const Key &lo, const Key &hi) const requires map::ORDER_STATISTICS {
+        if (RBTree<Key, T, Compare, Alloc, Policy, NodePool>::m_comp(hi, lo)) return 0;
+        return rank(hi) - rank(lo);
+    }
+
+    /**
+     * copies of the comparator of keys / of elements.
+     */
+    key_compare key_comp() const {
+        return RBTree<Key, T, Compare, Alloc, Policy, NodePool>::key_comp();
+    }
+    value_compare value_comp() const {
+        return value_compare(key_comp());
+    }
+
+    /**
+     * lazy views of the keys / the mapped values in ascending key order,
+     * the values can be modified through values().
+     */
+    auto keys() const {
+        return *this | views::keys;
+    }
+    auto values() {
+        return *this | views::values;
+    }
+    auto values() const {
+        return *this | views::values;
     }
 
     void debug() {
-        RBTree<Key, T, Compare>::print();
+        RBTree<Key, T, Compare, Alloc, Policy, NodePool>::print();
+    }
+
+  private:
+    using typename RBTree<Key, T, Compare, Alloc, Policy, NodePool>::set_op;
+    using RBTree<Key, T, Compare, Alloc, Policy, NodePool>::UNION;
+    using RBTree<Key, T, Compare, Alloc, Policy, NodePool>::INTERSECTION;
+    using RBTree<Key, T, Compare, Alloc, Policy, NodePool>::DIFFERENCE;
+
+    void combine_with(set_op op, map &&other, bool parallel) {
+        size_t n = other.size();
+        auto t = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::take_tree(other);
+        RBTree<Key, T, Compare, Alloc, Policy, NodePool>::combine(op, t, n, parallel);
+    }
+    void combine_with(set_op op, const map &other, bool parallel) {
+        auto t = RBTree<Key, T, Compare, Alloc, Policy, NodePool>::copy_tree(other);
+        RBTree<Key, T, Compare, Alloc, Policy, NodePool>::combine(op, t, other.size(), parallel);
     }
 };
 
@@ -0,0 +1,29 @@
+#ifndef SJTU_SHM_MAP_HPP
+#define SJTU_SHM_MAP_HPP
+
+#include "map.hpp"
+#include "shared_memory.hpp" // kept in vector/src, test.sh copies it next to this header
+
+namespace sjtu {
+/**
+ * a map living in a shm_segment, shared by several processes.
+ *
+ * the nodes are allocated in the segment and linked by offset_ptr,
+ * so the tree is valid wherever the segment is mapped. Key and T
+ * must not hold raw pointers either (e.g. use integers or fixed-size arrays).
+ *
+ *   auto seg = sjtu::shm_segment::create("/table", 64 << 20);
+ *   auto *m = seg.construct<sjtu::shm_map<int, int>>("ids", seg.get_allocator<int>());
+ *   ...
+ *   auto ro = sjtu::shm_segment::open("/table");   // in another process
+ *   const auto *t = ro.find<sjtu::shm_map<int, int>>("ids");
+ *
+ * writes are not synchronized: build the map in one process, the others
+ * attach read-only and only look it up.
+ */
+template<class Key, class T, class Compare = std::less<Key>>
+using shm_map = map<Key, T, Compare, shm_allocator<pair<const Key, T>>>;
+
+}
+
+#endif
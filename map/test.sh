@@ -1,6 +1,6 @@
 #!/usr/bin/bash
 
-tests=("one" "two" "three" "four" "five")
+tests=("one" "two" "three" "four" "five" "six" "seven" "eight" "nine" "ten" "eleven" "twelve" "thirteen" "fourteen" "fifteen")
 args="-fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20"
 memargs="-fmax-errors=10 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address,undefined,leak -g"
 
@@ -8,6 +8,7 @@ run_test() {
     mkdir testdir -p
     rm testdir/*
     cp src/*.hpp testdir
+    cp ../vector/src/shared_memory.hpp testdir
     cp data/class-bint.hpp testdir
     cp data/class-integer.hpp testdir
     cp data/class-matrix.hpp testdir
@@ -42,6 +43,7 @@ run_test_memcheck() {
     mkdir testdir -p
     rm testdir/*
     cp src/*.hpp testdir
+    cp ../vector/src/shared_memory.hpp testdir
     cp data/class-bint.hpp testdir
     cp data/class-integer.hpp testdir
     cp data/class-matrix.hpp testdir
@@ -0,0 +1,21 @@
+#!/usr/bin/bash
+
+# the benchmarks print timings only, there is nothing to compare against
+benches=("static_index" "tiered_vector")
+args="-O2 -DNDEBUG -std=c++20"
+
+mkdir -p benchdir
+rm -f benchdir/*
+cp src/*.hpp benchdir
+for bench in "${benches[@]}"
+do
+    echo
+    echo ">>> Bench $bench"
+    cp "bench/$bench.cpp" benchdir
+    g++ "benchdir/$bench.cpp" -o "benchdir/$bench" $args
+    if [ $? -ne 0 ]; then
+        echo "Bench $bench compiled failed"
+        exit 2
+    fi
+    "./benchdir/$bench"
+done
@@ -0,0 +1,45 @@
+#include "static_index.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+// ns per lower_bound query on random ints: static_index against std::lower_bound on the sorted vector
+const int QUERIES = 2000000;
+
+template<typename F>
+double ns_per_query(F query, long long &check)
+{
+	auto t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < QUERIES; ++i) {
+		check += query(i);
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / QUERIES;
+}
+
+int main()
+{
+	std::mt19937 rng(20261019);
+	std::printf("%10s %14s %18s\n", "n", "static_index", "std::lower_bound");
+	for (int n : {1000, 100000, 1000000, 10000000}) {
+		sjtu::vector<int> sorted;
+		for (int i = 0; i < n; ++i) {
+			sorted.push_back(rng());
+		}
+		std::sort(sorted.begin(), sorted.end());
+		sjtu::static_index<int> idx(sorted);
+		sjtu::vector<int> queries;
+		for (int i = 0; i < QUERIES; ++i) {
+			queries.push_back(rng());
+		}
+		long long a = 0, b = 0;
+		double tree = ns_per_query([&](int i) { return idx.lower_bound(queries[i]); }, a);
+		double flat = ns_per_query([&](int i) {
+			return std::lower_bound(sorted.begin(), sorted.end(), queries[i]) - sorted.begin();
+		}, b);
+		std::printf("%10d %11.1f ns %15.1f ns%s\n", n, tree, flat, a == b ? "" : "  (results differ)");
+	}
+	return 0;
+}
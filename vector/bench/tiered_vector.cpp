@@ -0,0 +1,42 @@
+#include "tiered_vector.hpp"
+#include "vector.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+// us per operation of alternating random insert / erase on n ints: tiered_vector against sjtu::vector
+template<typename V>
+double us_per_op(int n, int ops, long long &check)
+{
+	std::mt19937 rng(20261019);
+	V v;
+	for (int i = 0; i < n; ++i) {
+		v.push_back(i);
+	}
+	auto t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < ops; ++i) {
+		if (i % 2 == 0) v.insert(size_t(rng() % (v.size() + 1)), i);
+		else v.erase(size_t(rng() % v.size()));
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < v.size(); i += 997) {
+		check += v[i];
+	}
+	return std::chrono::duration<double, std::micro>(t1 - t0).count() / ops;
+}
+
+volatile long long sink; // keeps the final contents observable
+
+int main()
+{
+	std::printf("%10s %14s %14s\n", "n", "tiered_vector", "sjtu::vector");
+	for (int n : {10000, 100000, 1000000}) {
+		long long a = 0, b = 0;
+		double tiered = us_per_op<sjtu::tiered_vector<int>>(n, 200000, a);
+		double flat = us_per_op<sjtu::vector<int>>(n, n >= 1000000 ? 2000 : 20000, b);
+		std::printf("%10d %11.2f us %11.2f us\n", n, tiered, flat);
+		sink = a + b;
+	}
+	return 0;
+}
@@ -0,0 +1,92 @@
+#include "static_vector.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <ranges>
+#include <string>
+#include <type_traits>
+
+static_assert(std::ranges::random_access_range<sjtu::static_vector<int, 4>>);
+static_assert(std::ranges::contiguous_range<sjtu::static_vector<int, 4>>);
+static_assert(std::ranges::contiguous_range<const sjtu::static_vector<std::string, 4>>);
+static_assert(std::is_trivially_copyable_v<sjtu::static_vector<int, 4>>);
+static_assert(!std::is_trivially_copyable_v<sjtu::static_vector<std::string, 4>>);
+
+constexpr int sorted_sum()
+{
+	sjtu::static_vector<int, 8> v;
+	for (int x : {5, 3, 8, 1}) {
+		v.push_back(x);
+	}
+	std::ranges::sort(v);
+	v.insert(v.begin() + 1, 2);
+	v.erase(0);
+	int s = 0;
+	for (auto it = v.begin(); it < v.end(); ++it) {
+		s = s * 10 + *it;
+	}
+	return s;
+}
+static_assert(sorted_sum() == 2358);
+
+template<typename V>
+void print(const V &v)
+{
+	for (const auto &x : v) {
+		std::cout << x << " ";
+	}
+	std::cout << std::endl;
+}
+
+void TestIterators()
+{
+	std::cout << "Testing iterators..." << std::endl;
+	sjtu::static_vector<int, 16> v;
+	for (int i = 0; i < 16; ++i) {
+		v.push_back((i * 7) % 16);
+	}
+	std::ranges::sort(v);
+	print(v);
+	auto it = std::ranges::lower_bound(v, 9);
+	std::cout << *it << " " << (it - v.begin()) << " " << *(2 + it) << " " << it[-1] << std::endl;
+	sjtu::static_vector<int, 16>::const_iterator a = v.cbegin() + 3, b = v.cend() - 3;
+	std::cout << (a < b) << (a > b) << (a <= a) << (b >= a) << (a == b) << (a != b) << std::endl;
+	std::ranges::reverse(v);
+	print(v);
+	auto odd = v | std::views::filter([](int x) { return x % 2; });
+	std::cout << std::ranges::distance(odd) << std::endl;
+}
+
+void TestFull()
+{
+	std::cout << "Testing a full static_vector..." << std::endl;
+	sjtu::static_vector<std::string, 4> v;
+	for (int i = 0; i < 4; ++i) {
+		v.push_back(std::string(20, char('a' + i)));
+	}
+	std::cout << v.full() << " " << v.size() << " " << v.capacity() << std::endl;
+	try {
+		v.push_back("x");
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound" << std::endl;
+	}
+	try {
+		v.insert(0, "x");
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound" << std::endl;
+	}
+	v.erase(v.begin());
+	v.insert(1, v[0]);
+	print(v);
+	sjtu::static_vector<std::string, 4> w(v);
+	v.clear();
+	std::cout << v.empty() << " " << w.size() << " " << w.back() << std::endl;
+}
+
+int main()
+{
+	TestIterators();
+	TestFull();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include "slot_map.hpp"
+
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+const int N = 20000;
+
+// moving it throws once the budget runs out, copying never does
+struct Value {
+	static int budget;
+	static int alive;
+	std::string s;
+	Value(const std::string &s) : s(s) {
+		++alive;
+	}
+	Value(const Value &other) : s(other.s) {
+		++alive;
+	}
+	Value(Value &&other) : s(std::move(other.s)) {
+		if (budget-- == 0) throw std::string("move failed");
+		++alive;
+	}
+	Value &operator=(const Value &other) = default;
+	Value &operator=(Value &&other) = default;
+	~Value() {
+		--alive;
+	}
+};
+
+int Value::budget = -1;
+int Value::alive = 0;
+
+typedef sjtu::slot_map<Value> Map;
+
+bool consistent(const Map &m, const std::vector<std::pair<Map::key, std::string>> &live)
+{
+	if (m.size() != live.size()) return false;
+	for (auto &kv : live) {
+		const Value *v = m.find(kv.first);
+		if (v == nullptr || v->s != kv.second) return false;
+	}
+	for (size_t i = 0; i < m.size(); ++i) {
+		if (m[m.key_at(i)].s != m.data()[i].s) return false;
+	}
+	return true;
+}
+
+void TestStaleKeys()
+{
+	std::cout << "Testing stale keys..." << std::endl;
+	Map m;
+	Map::key a = m.insert(Value("a")), b = m.emplace(std::string("b"));
+	std::cout << m.size() << " " << m[a].s << m[b].s << std::endl;
+	m.erase(a);
+	Map::key c = m.insert(Value("c"));
+	std::cout << (c.index == a.index) << " " << m.contains(a) << " " << (m.find(a) == nullptr) << " " << m.erase(a) << std::endl;
+	try {
+		m.at(a);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound" << std::endl;
+	}
+	m.clear();
+	std::cout << m.size() << " " << m.contains(b) << " " << m.contains(c) << std::endl;
+	Map::key d = m.insert(Value("d"));
+	std::cout << m.contains(d) << " " << m[d].s << std::endl;
+}
+
+void TestRandom()
+{
+	std::cout << "Testing random inserts, erases and failed inserts..." << std::endl;
+	std::mt19937 rng(20261019);
+	std::vector<std::pair<Map::key, std::string>> live, dead;
+	int failures = 0;
+	bool ok = true;
+	{
+		Map m;
+		for (int i = 0; i < N; ++i) {
+			int op = rng() % 10;
+			if (op < 6 || live.empty()) {
+				std::string s = "value " + std::to_string(i) + std::string(20, 'v');
+				// an insert moves the value into a temporary, then into the dense array
+				Value::budget = op == 0 ? 1 : -1;
+				try {
+					live.push_back({m.insert(Value(s)), s});
+				} catch (std::string &) {
+					++failures;
+				}
+				Value::budget = -1;
+			} else if (op < 9) {
+				size_t k = rng() % live.size();
+				if (m.erase(live[k].first) != 1) ok = false;
+				dead.push_back(live[k]);
+				live[k] = live.back();
+				live.pop_back();
+			} else if (!dead.empty()) {
+				if (m.contains(dead[rng() % dead.size()].first)) ok = false;
+			}
+			if (i % 1000 == 0 && !consistent(m, live)) ok = false;
+		}
+		ok = ok && consistent(m, live);
+		std::cout << failures << " " << m.size() << " " << (ok ? "ok" : "wrong") << std::endl;
+		std::cout << (Value::alive == (int)m.size()) << std::endl;
+	}
+	std::cout << Value::alive << std::endl;
+}
+
+int main()
+{
+	TestStaleKeys();
+	TestRandom();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,147 @@
+#include "roaring_bitmap.hpp"
+
+#include <iostream>
+#include <random>
+#include <set>
+
+const int N = 20000;
+
+typedef sjtu::roaring_bitmap Bitmap;
+
+bool same(const Bitmap &b, const std::set<uint32_t> &ref)
+{
+	if (b.cardinality() != ref.size() || b.empty() != ref.empty()) return false;
+	sjtu::vector<uint32_t> v = b.to_vector();
+	auto it = ref.begin();
+	for (size_t i = 0; i < v.size(); ++i, ++it) {
+		if (v[i] != *it) return false;
+	}
+	return true;
+}
+
+// values spread over a few containers: sparse (array), dense (bitmap) and long intervals (runs)
+void fill(std::mt19937 &rng, Bitmap &b, std::set<uint32_t> &ref, int n)
+{
+	for (int i = 0; i < n; ++i) {
+		uint32_t x;
+		switch (rng() % 4) {
+		case 0: x = rng() % (1u << 24); break;
+		case 1: x = (3u << 16) | (rng() % 65536); break;
+		case 2: x = (7u << 16) | (rng() % 3000); break;
+		default: x = UINT32_MAX - rng() % 20000;
+		}
+		b.add(x);
+		ref.insert(x);
+	}
+}
+
+void TestBasic()
+{
+	std::cout << "Testing add / remove / contains..." << std::endl;
+	Bitmap b;
+	std::cout << b.empty() << " " << b.size() << " " << b.contains(0) << std::endl;
+	std::cout << b.add(0) << b.add(0) << b.add(UINT32_MAX) << b.add(65536) << " " << b.size() << std::endl;
+	std::cout << b.contains(0) << b.contains(1) << b.contains(UINT32_MAX) << b.contains(65536) << std::endl;
+	std::cout << b.remove(1) << b.remove(0) << b.remove(0) << " " << b.size() << std::endl;
+	// an array container grows into a bitmap and shrinks back
+	for (uint32_t x = 0; x < 10000; ++x) b.add(x * 2);
+	std::cout << b.size() << " " << b.contains(9998) << b.contains(9999) << std::endl;
+	for (uint32_t x = 0; x < 10000; ++x) b.remove(x * 2);
+	std::cout << b.size() << " " << b.contains(65536) << std::endl;
+	b.clear();
+	std::cout << b.empty() << std::endl;
+}
+
+void TestAlgebra()
+{
+	std::cout << "Testing set algebra..." << std::endl;
+	std::mt19937 rng(20261019);
+	Bitmap a, b;
+	std::set<uint32_t> ra, rb;
+	fill(rng, a, ra, N);
+	fill(rng, b, rb, N / 2);
+	for (uint32_t x = 100000; x < 200000; ++x) {
+		a.add(x);
+		ra.insert(x);
+	}
+	std::set<uint32_t> rand_, ror, rdiff, rxor;
+	for (uint32_t x : ra) (rb.count(x) ? rand_ : rdiff).insert(x);
+	ror = ra;
+	ror.insert(rb.begin(), rb.end());
+	rxor = rdiff;
+	for (uint32_t x : rb) {
+		if (!ra.count(x)) rxor.insert(x);
+	}
+	std::cout << same(a, ra) << same(b, rb) << same(a & b, rand_) << same(a | b, ror) << same(a - b, rdiff) << same(a ^ b, rxor) << std::endl;
+	Bitmap c = a;
+	c &= b;
+	Bitmap d = a;
+	d |= b;
+	Bitmap e = a;
+	e -= b;
+	Bitmap f = a;
+	f ^= b;
+	std::cout << same(c, rand_) << same(d, ror) << same(e, rdiff) << same(f, rxor) << std::endl;
+	std::cout << ((a - a).empty()) << ((a ^ a).empty()) << (a == (a | a)) << (a == (a & a)) << (a != b) << std::endl;
+
+	// runs keep the same set in less memory and take part in the same operations
+	Bitmap g = a;
+	size_t before = g.memory_usage();
+	g.run_optimize();
+	std::cout << (g == a) << (g.memory_usage() < before) << same(g, ra) << same(g & b, rand_) << same(b | g, ror) << same(g ^ b, rxor) << std::endl;
+	bool ok = true;
+	for (int i = 0; i < N; ++i) {
+		uint32_t x = i % 2 ? rng() : 100000 + rng() % 100000;
+		ok = ok && g.contains(x) == (ra.count(x) > 0);
+	}
+	std::cout << ok << std::endl;
+	g.remove(150000);
+	g.add(250000);
+	ra.erase(150000);
+	ra.insert(250000);
+	std::cout << same(g, ra) << std::endl;
+}
+
+void TestSerialize()
+{
+	std::cout << "Testing serialize..." << std::endl;
+	std::mt19937 rng(20261019);
+	Bitmap a;
+	std::set<uint32_t> ra;
+	fill(rng, a, ra, N / 3);
+	for (uint32_t x = 500000; x < 600000; ++x) a.add(x);
+	a.run_optimize();
+	sjtu::vector<uint8_t> bytes = a.serialize();
+	Bitmap b = Bitmap::deserialize(bytes);
+	std::cout << (a == b) << " " << (Bitmap::deserialize(Bitmap().serialize()).empty()) << std::endl;
+	sjtu::vector<uint8_t> broken = bytes;
+	broken.pop_back();
+	try {
+		Bitmap::deserialize(broken);
+	} catch (sjtu::runtime_error &) {
+		std::cout << "truncated" << std::endl;
+	}
+	broken = bytes;
+	broken[0] ^= 1;
+	try {
+		Bitmap::deserialize(broken);
+	} catch (sjtu::runtime_error &) {
+		std::cout << "bad cookie" << std::endl;
+	}
+	sjtu::vector<uint32_t> values;
+	values.push_back(5);
+	values.push_back(1);
+	values.push_back(5);
+	Bitmap c(values);
+	sjtu::vector<uint32_t> out = c.to_vector();
+	std::cout << out.size() << " " << out[0] << " " << out[1] << std::endl;
+}
+
+int main()
+{
+	TestBasic();
+	TestAlgebra();
+	TestSerialize();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,99 @@
+#include "shm_vector.hpp"
+
+#include <iostream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+const int ROUNDS = 5;
+const int GROW = 200000;
+
+std::string segment_name()
+{
+	return "/sjtu_vector_five_" + std::to_string(getpid());
+}
+
+void TestForkAndAttach()
+{
+	std::cout << "Testing a second process attaching to the segment..." << std::endl;
+	std::string name = segment_name();
+	sjtu::shm_segment::remove(name.c_str());
+	auto seg = sjtu::shm_segment::create(name.c_str(), 1 << 20);
+	auto *v = seg.construct<sjtu::shm_vector<long long>>("v", seg.get_allocator<long long>());
+	for (int i = 0; i < 10; ++i) {
+		v->push_back(i * i);
+	}
+	pid_t pid = fork();
+	if (pid == 0) {
+		// the child maps the segment at another address, reads and appends
+		int status = 0;
+		try {
+			auto rw = sjtu::shm_segment::open(name.c_str(), false);
+			auto *w = rw.find<sjtu::shm_vector<long long>>("v");
+			if (w == nullptr || w->size() != 10 || (*w)[9] != 81) {
+				status = 1;
+			} else {
+				for (int i = 10; i < 1000; ++i) {
+					w->push_back(i * i);
+				}
+			}
+			if (rw.find<int>("missing") != nullptr) status = 2;
+		} catch (...) {
+			status = 3;
+		}
+		_exit(status);
+	}
+	int status;
+	waitpid(pid, &status, 0);
+	std::cout << "child exit " << (WIFEXITED(status) ? WEXITSTATUS(status) : -1) << std::endl;
+	std::cout << v->size() << std::endl;
+	long long sum = 0;
+	bool ok = true;
+	for (size_t i = 0; i < v->size(); ++i) {
+		sum += (*v)[i];
+		ok = ok && (*v)[i] == (long long)(i * i);
+	}
+	std::cout << sum << " " << (ok ? "ok" : "wrong") << std::endl;
+	auto ro = sjtu::shm_segment::open(name.c_str());
+	const auto *r = ro.find<sjtu::shm_vector<long long>>("v");
+	std::cout << (r != nullptr && r->size() == v->size() && r->back() == 999 * 999 ? "read-only ok" : "read-only wrong") << std::endl;
+	seg.destroy<sjtu::shm_vector<long long>>("v");
+	sjtu::shm_segment::remove(name.c_str());
+}
+
+void TestSpaceReuse()
+{
+	std::cout << "Testing that freed space is reused..." << std::endl;
+	std::string name = segment_name();
+	sjtu::shm_segment::remove(name.c_str());
+	// every round grows a vector to a quarter of the segment by doubling,
+	// which only fits if the old buffers are merged and handed out again
+	auto seg = sjtu::shm_segment::create(name.c_str(), 4 << 20);
+	int done = 0;
+	try {
+		for (int r = 0; r < ROUNDS; ++r) {
+			auto *v = seg.construct<sjtu::shm_vector<int>>("v", seg.get_allocator<int>());
+			for (int i = 0; i < GROW; ++i) {
+				v->push_back(i);
+			}
+			auto *s = seg.construct<sjtu::shm_vector<int>>("small", seg.get_allocator<int>());
+			for (int i = 0; i < 100; ++i) {
+				s->push_back(i);
+			}
+			seg.destroy<sjtu::shm_vector<int>>("v");
+			seg.destroy<sjtu::shm_vector<int>>("small");
+			++done;
+		}
+	} catch (sjtu::runtime_error &) {
+		std::cout << "segment full" << std::endl;
+	}
+	std::cout << done << " rounds" << std::endl;
+	sjtu::shm_segment::remove(name.c_str());
+}
+
+int main()
+{
+	TestForkAndAttach();
+	TestSpaceReuse();
+	return 0;
+}
@@ -0,0 +1,89 @@
+#include "vector.hpp"
+
+#include <array>
+#include <iostream>
+#include <string>
+
+const int N = 100000;
+
+// everything below the line is evaluated by the compiler
+constexpr int sum_of_squares(int n)
+{
+	sjtu::vector<int> v;
+	for (int i = 0; i < n; ++i) v.push_back(i * i);
+	sjtu::vector<int> w = v;
+	w.insert(0, -1);
+	w.erase(w.begin());
+	int s = 0;
+	for (auto it = w.begin(); it != w.end(); ++it) s += *it;
+	while (!w.empty()) w.pop_back();
+	return s;
+}
+static_assert(sum_of_squares(10) == 285);
+
+constexpr auto primes = sjtu::freeze<[] {
+	sjtu::vector<int> v;
+	for (int i = 2; i < 100; ++i) {
+		bool prime = true;
+		for (int p : v) {
+			if (i % p == 0) {
+				prime = false;
+				break;
+			}
+		}
+		if (prime) v.push_back(i);
+	}
+	return v;
+}>();
+static_assert(primes.size() == 25 && primes[0] == 2 && primes[24] == 97);
+
+constexpr auto words = sjtu::freeze<[] {
+	sjtu::vector<std::string> v;
+	v.push_back("constant");
+	v.push_back(std::string("evaluation"));
+	v.insert(1, "time");
+	v.erase(1);
+	sjtu::vector<std::string> w = std::move(v);
+	w.push_back("ok");
+	sjtu::vector<size_t> lengths;
+	for (const std::string &s : w) lengths.push_back(s.size());
+	return lengths;
+}>();
+static_assert(words.size() == 3 && words[0] == 8 && words[1] == 10 && words[2] == 2);
+
+void TestFrozen()
+{
+	std::cout << "Testing frozen tables..." << std::endl;
+	for (int p : primes) std::cout << p << " ";
+	std::cout << std::endl;
+	for (size_t n : words) std::cout << n << " ";
+	std::cout << std::endl;
+	std::cout << sum_of_squares(10) << std::endl;
+}
+
+void TestRuntime()
+{
+	std::cout << "Testing the same code at run time..." << std::endl;
+	// the constexpr functions are also plain functions
+	std::cout << sum_of_squares(N / 1000) << std::endl;
+	sjtu::vector<long long> v;
+	for (int i = 0; i < N; ++i) v.push_back(1LL * i * i);
+	sjtu::vector<long long> h;
+	for (int i = N - 4; i < N; ++i) h.push_back(v[i]);
+	std::array<long long, 4> head = sjtu::to_array<4>(h);
+	for (long long x : head) std::cout << x << " ";
+	std::cout << std::endl;
+	try {
+		sjtu::to_array<3>(v);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "size mismatch" << std::endl;
+	}
+}
+
+int main()
+{
+	TestFrozen();
+	TestRuntime();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,130 @@
+#include "poly_vector.hpp"
+
+#include <iostream>
+#include <string>
+
+const int N = 10000;
+
+struct Shape {
+	virtual ~Shape() = default;
+	virtual long long area() const = 0;
+};
+
+struct Square final : Shape {
+	int side;
+	Square(int side) : side(side) {}
+	long long area() const override {
+		return 1LL * side * side;
+	}
+};
+
+struct Named final : Shape {
+	std::string name;
+	Named(const std::string &name) : name(name) {}
+	long long area() const override {
+		return name.size();
+	}
+};
+
+// copying it throws once the budget runs out, and it has no noexcept move
+struct Fragile : Shape {
+	static int budget;
+	static int alive;
+	std::string name;
+	Fragile(const std::string &name) : name(name) {
+		++alive;
+	}
+	Fragile(const Fragile &other) : name(other.name) {
+		if (budget-- == 0) throw std::string("copy failed");
+		++alive;
+	}
+	~Fragile() {
+		--alive;
+	}
+	long long area() const override {
+		return name.size();
+	}
+};
+
+int Fragile::budget = -1;
+int Fragile::alive = 0;
+
+long long total(const sjtu::poly_vector<Shape> &v)
+{
+	long long s = 0;
+	for (const Shape &x : v) {
+		s += x.area();
+	}
+	return s;
+}
+
+void TestMixed()
+{
+	std::cout << "Testing objects of different types..." << std::endl;
+	sjtu::poly_vector<Shape> v;
+	for (int i = 0; i < N; ++i) {
+		if (i % 3 == 0) v.emplace_back<Named>(std::string(i % 50 + 1, 'n'));
+		else v.emplace_back<Square>(i % 100);
+	}
+	long long squares = 0, names = 0;
+	v.for_each<Square>([&](Square &s) { squares += s.area(); });
+	v.for_each<Named>([&](const Named &s) { names += s.area(); });
+	std::cout << v.size() << " " << v.count<Square>() << " " << v.count<Named>() << std::endl;
+	std::cout << total(v) << " " << squares + names << std::endl;
+	while (v.size() > 10) {
+		v.pop_back();
+	}
+	std::cout << v.size() << " " << v.count<Square>() << " " << v.count<Named>() << " " << total(v) << std::endl;
+	// the argument is an element of the container, which moves while it grows
+	for (int i = 0; i < 1000; ++i) {
+		v.emplace_back<Named>(static_cast<const Named &>(v[0]));
+	}
+	std::cout << v.count<Named>() << " " << total(v) << std::endl;
+	v.clear();
+	v.emplace_back<Square>(7);
+	std::cout << v.size() << " " << v.count<Named>() << " " << total(v) << std::endl;
+}
+
+void TestThrowingGrowth()
+{
+	std::cout << "Testing a copy throwing while the arena grows..." << std::endl;
+	{
+		sjtu::poly_vector<Shape> v;
+		int failures = 0;
+		for (int i = 0; i < 2000; ++i) {
+			size_t before = v.size(), cap = v.capacity_bytes();
+			long long sum = total(v);
+			// the new element is built in place, the only copies are made by a growth,
+			// which fails halfway the first time
+			Fragile::budget = int(v.count<Fragile>() / 2);
+			for (bool done = false; !done;) {
+				try {
+					if (i % 2) v.emplace_back<Fragile>(std::string(30, 'f'));
+					else v.emplace_back<Square>(3);
+					done = true;
+				} catch (std::string &) {
+					++failures;
+					if (v.size() != before || v.capacity_bytes() != cap || total(v) != sum) {
+						std::cout << "changed after a failed growth" << std::endl;
+					}
+					if (Fragile::alive != (int)v.count<Fragile>()) {
+						std::cout << "leaked after a failed growth" << std::endl;
+					}
+					Fragile::budget = -1;
+				}
+			}
+			Fragile::budget = -1;
+		}
+		std::cout << failures << " " << v.size() << " " << v.count<Fragile>() << " " << total(v) << std::endl;
+		std::cout << (Fragile::alive == (int)v.count<Fragile>()) << std::endl;
+	}
+	std::cout << Fragile::alive << std::endl;
+}
+
+int main()
+{
+	TestMixed();
+	TestThrowingGrowth();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,122 @@
+#include "devector.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <ranges>
+#include <string>
+
+const int N = 100000;
+
+static_assert(std::ranges::contiguous_range<sjtu::devector<int>>);
+static_assert(std::ranges::contiguous_range<const sjtu::devector<int>>);
+
+template<typename D>
+void print(const D &d)
+{
+	for (auto it = d.begin(); it != d.end(); ++it) {
+		std::cout << *it << " ";
+	}
+	std::cout << std::endl;
+}
+
+void TestFront()
+{
+	std::cout << "Testing insert and erase at index 0..." << std::endl;
+	sjtu::devector<int> d;
+	d.insert(0, 3);
+	d.insert(0, 1);
+	d.insert(1, 2);
+	d.insert(d.size(), 4);
+	print(d);
+	d.erase(0);
+	print(d);
+	d.insert(d.begin(), 0);
+	d.erase(d.begin() + 1);
+	d.insert(d.end(), 5);
+	print(d);
+	for (int i = 0; i < 40; ++i) {
+		d.insert(0, -i);
+	}
+	std::cout << d.size() << " " << d.front() << " " << d.back() << std::endl;
+	while (d.size() > 2) {
+		d.erase(0);
+	}
+	print(d);
+	try {
+		d.erase(2);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound" << std::endl;
+	}
+	try {
+		d.insert(3, 1);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound" << std::endl;
+	}
+}
+
+void TestBothEnds()
+{
+	std::cout << "Testing push and pop at both ends..." << std::endl;
+	sjtu::devector<long long> d;
+	for (int i = 0; i < N; ++i) {
+		if (i % 3 == 0) d.push_front(i);
+		else d.push_back(i);
+	}
+	long long sum = 0;
+	for (long long x : d) {
+		sum += x;
+	}
+	std::cout << d.size() << " " << sum << " " << d.front() << " " << d.back() << std::endl;
+	std::sort(d.begin(), d.end());
+	std::cout << std::is_sorted(d.cbegin(), d.cend()) << " " << d[0] << " " << d[N - 1] << std::endl;
+	for (int i = 0; i < N / 2; ++i) {
+		d.pop_front();
+		d.pop_back();
+	}
+	std::cout << d.size() << " " << (d.begin() == d.end()) << std::endl;
+}
+
+void TestRandom()
+{
+	std::cout << "Testing random inserts and erases..." << std::endl;
+	std::mt19937 rng(20261019);
+	sjtu::devector<std::string> d;
+	std::deque<std::string> ref;
+	bool ok = true;
+	for (int i = 0; i < N; ++i) {
+		int op = rng() % 5;
+		std::string v = std::to_string(rng() % 1000) + std::string(rng() % 30, 'z');
+		if (op < 2) {
+			size_t k = rng() % (ref.size() + 1);
+			d.insert(k, v);
+			ref.insert(ref.begin() + k, v);
+		} else if (op == 2 && !ref.empty()) {
+			// the value is an element of the devector itself
+			size_t k = rng() % ref.size();
+			d.insert(k, d[k]);
+			ref.insert(ref.begin() + k, ref[k]);
+		} else if (op == 3 && !ref.empty()) {
+			size_t k = rng() % ref.size();
+			d.erase(d.begin() + k);
+			ref.erase(ref.begin() + k);
+		} else {
+			d.push_front(v);
+			ref.push_front(v);
+		}
+	}
+	ok = d.size() == ref.size() && std::equal(d.begin(), d.end(), ref.begin());
+	sjtu::devector<std::string> copy(d);
+	ok = ok && std::equal(copy.begin(), copy.end(), ref.begin(), ref.end());
+	std::cout << d.size() << " " << (ok ? "ok" : "wrong") << std::endl;
+}
+
+int main()
+{
+	TestFront();
+	TestBothEnds();
+	TestRandom();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,189 @@
+#include "hive.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+const int N = 200000;
+
+template<typename H>
+void print(const H &h)
+{
+	for (auto it = h.begin(); it != h.end(); ++it) {
+		std::cout << *it << " ";
+	}
+	std::cout << "|";
+	for (auto it = h.end(); it != h.begin();) {
+		--it;
+		std::cout << " " << *it;
+	}
+	std::cout << std::endl;
+}
+
+std::string key(int x)
+{
+	return "value-" + std::to_string(x);
+}
+
+void TestEraseRuns()
+{
+	std::cout << "Testing erase in a block..." << std::endl;
+	sjtu::hive<int> h;
+	std::vector<sjtu::hive<int>::iterator> its;
+	for (int i = 0; i < 8; ++i) {
+		its.push_back(h.insert(i));
+	}
+	h.erase(its[3]); // middle
+	print(h);
+	h.erase(its[0]); // first
+	print(h);
+	h.erase(its[7]); // last
+	print(h);
+	h.erase(its[2]); // grows the run of 3 to the left
+	h.erase(its[4]); // and to the right
+	print(h);
+	h.erase(its[1]); // joins it with the run of 0
+	print(h);
+	std::cout << h.size() << " " << h.capacity() << std::endl;
+}
+
+void TestFreeListReuse()
+{
+	std::cout << "Testing reuse of erased slots..." << std::endl;
+	sjtu::hive<std::string> h;
+	std::vector<const std::string *> addr;
+	for (int i = 0; i < 32; ++i) {
+		addr.push_back(&*h.insert(key(i)));
+	}
+	size_t cap = h.capacity();
+	std::vector<const std::string *> erased;
+	for (int i = 0; i < 32; i += 3) {
+		erased.push_back(addr[i]);
+		h.erase(h.get_iterator(addr[i]));
+	}
+	bool reused = true;
+	for (int i = 0; i < (int)erased.size(); ++i) {
+		const std::string *p = &*h.insert(key(100 + i));
+		if (std::find(erased.begin(), erased.end(), p) == erased.end()) reused = false;
+	}
+	std::cout << (reused ? "reused" : "not reused") << " " << (h.capacity() == cap ? "same capacity" : "grown") << std::endl;
+	std::cout << h.size() << std::endl;
+	std::vector<std::string> all(h.begin(), h.end());
+	std::sort(all.begin(), all.end());
+	std::cout << all.front() << " " << all.back() << std::endl;
+}
+
+void TestEmptyBlock()
+{
+	std::cout << "Testing a block becoming empty..." << std::endl;
+	sjtu::hive<int> h;
+	std::vector<sjtu::hive<int>::iterator> its;
+	for (int i = 0; i < 32; ++i) {
+		its.push_back(h.insert(i)); // blocks of 8, 8 and 16
+	}
+	std::cout << h.capacity() << std::endl;
+	for (int i = 8; i < 16; ++i) {
+		h.erase(its[i]);
+	}
+	std::cout << h.size() << " " << h.capacity() << std::endl;
+	int sum = 0, cnt = 0;
+	for (int x : h) {
+		sum += x;
+		++cnt;
+	}
+	std::cout << cnt << " " << sum << std::endl;
+	for (int i = 0; i < 8; ++i) {
+		h.erase(its[i]);
+	}
+	for (int i = 16; i < 32; ++i) {
+		h.erase(its[i]);
+	}
+	std::cout << h.size() << " " << h.capacity() << " " << (h.begin() == h.end()) << std::endl;
+	for (int i = 0; i < 4; ++i) {
+		h.insert(i);
+	}
+	print(h);
+}
+
+void TestDecrementBegin()
+{
+	std::cout << "Testing decrement of begin()..." << std::endl;
+	sjtu::hive<int> h;
+	try {
+		auto it = h.end();
+		--it;
+		std::cout << "no exception" << std::endl;
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << "empty: invalid_iterator" << std::endl;
+	}
+	std::vector<sjtu::hive<int>::iterator> its;
+	for (int i = 0; i < 20; ++i) {
+		its.push_back(h.insert(i));
+	}
+	h.erase(its[0]);
+	h.erase(its[1]);
+	auto it = h.begin();
+	try {
+		--it;
+		std::cout << "no exception" << std::endl;
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << "invalid_iterator, still at " << *it << std::endl;
+	}
+	sjtu::hive<int>::const_iterator cit = h.cbegin();
+	try {
+		cit--;
+		std::cout << "no exception" << std::endl;
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << "invalid_iterator, still at " << *cit << std::endl;
+	}
+	std::cout << *--h.end() << std::endl;
+}
+
+void TestRandom()
+{
+	std::cout << "Testing random inserts and erases..." << std::endl;
+	std::mt19937 rng(20261019);
+	sjtu::hive<std::string> h;
+	std::vector<const std::string *> live;
+	std::vector<std::string> ref;
+	long long ops = 0;
+	for (int i = 0; i < N; ++i) {
+		if (live.empty() || rng() % 5 < 3) {
+			live.push_back(&*h.insert(key(i)));
+		} else {
+			size_t k = rng() % live.size();
+			h.erase(h.get_iterator(live[k]));
+			live[k] = live.back();
+			live.pop_back();
+		}
+		++ops;
+	}
+	for (const std::string *p : live) {
+		ref.push_back(*p);
+	}
+	std::vector<std::string> fwd(h.begin(), h.end()), rev;
+	for (auto it = h.end(); it != h.begin();) {
+		rev.push_back(*--it);
+	}
+	std::reverse(rev.begin(), rev.end());
+	bool ok = fwd == rev && fwd.size() == h.size();
+	std::sort(fwd.begin(), fwd.end());
+	std::sort(ref.begin(), ref.end());
+	ok = ok && fwd == ref;
+	std::cout << ops << " " << h.size() << " " << (ok ? "ok" : "wrong") << std::endl;
+	h.clear();
+	std::cout << h.size() << " " << h.capacity() << std::endl;
+}
+
+int main()
+{
+	TestEraseRuns();
+	TestFreeListReuse();
+	TestEmptyBlock();
+	TestDecrementBegin();
+	TestRandom();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include "jagged_vector.hpp"
+
+#include <iostream>
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+
+const int N = 20000;
+
+template<typename T>
+bool same(const sjtu::jagged_vector<T> &j, const std::vector<std::vector<T>> &ref)
+{
+	if (j.rows() != ref.size() || j.empty() != ref.empty()) return false;
+	size_t total = 0;
+	for (size_t i = 0; i < ref.size(); ++i) {
+		std::span<const T> r = j[i];
+		if (r.size() != ref[i].size() || j.row_size(i) != ref[i].size() || j.offsets()[i] != total) return false;
+		for (size_t k = 0; k < r.size(); ++k) {
+			if (!(r[k] == ref[i][k]) || !(j.data()[total + k] == ref[i][k])) return false;
+		}
+		total += r.size();
+	}
+	if (j.size() != total || size_t(j.end() - j.begin()) != total) return false;
+	size_t k = 0;
+	for (const T &x : j) {
+		if (!(&x == j.data() + k++)) return false;
+	}
+	return true;
+}
+
+void TestRows()
+{
+	std::cout << "Testing rows..." << std::endl;
+	sjtu::jagged_vector<std::string> j;
+	std::vector<std::vector<std::string>> ref;
+	std::cout << j.empty() << " " << j.rows() << " " << j.size() << std::endl;
+	try {
+		j.push_back("x");
+	} catch (sjtu::container_is_empty &) {
+		std::cout << "no row" << std::endl;
+	}
+	std::vector<std::string> words = {"one", "two", "three"};
+	j.push_row(words);
+	j.push_row();
+	j.push_row(std::vector<std::string>{"four"});
+	j.push_back("five");
+	ref = {{"one", "two", "three"}, {}, {"four", "five"}};
+	std::cout << same(j, ref) << " " << j.rows() << " " << j.size() << std::endl;
+	for (std::string &s : j[0]) s += "!";
+	std::cout << j[0][2] << " " << j.row(2)[1] << " " << j.row_size(1) << std::endl;
+	j.pop_row();
+	std::cout << j.rows() << " " << j.size() << std::endl;
+	try {
+		j.row(2);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "no such row" << std::endl;
+	}
+	j.pop_row();
+	j.pop_row();
+	try {
+		j.pop_row();
+	} catch (sjtu::container_is_empty &) {
+		std::cout << "no row to pop" << std::endl;
+	}
+	j.push_row(std::views::iota(0, 3) | std::views::transform([](int i) { return std::to_string(i); }));
+	std::cout << j[0][0] << j[0][1] << j[0][2] << std::endl;
+	j.clear();
+	std::cout << j.empty() << " " << j.size() << " " << j.offsets()[0] << std::endl;
+}
+
+void TestRandom()
+{
+	std::cout << "Testing random rows..." << std::endl;
+	std::mt19937 rng(20261019);
+	sjtu::jagged_vector<int> j;
+	std::vector<std::vector<int>> ref;
+	bool ok = true;
+	for (int i = 0; i < N; ++i) {
+		int op = rng() % 10;
+		if (op < 3 || ref.empty()) {
+			std::vector<int> row(rng() % 8);
+			for (int &x : row) x = rng() % 1000;
+			j.push_row(row);
+			ref.push_back(row);
+		} else if (op < 9) {
+			int x = rng() % 1000;
+			j.push_back(x);
+			ref.back().push_back(x);
+		} else {
+			j.pop_row();
+			ref.pop_back();
+		}
+		if (i % (N / 20) == 0) ok = ok && same(j, ref);
+	}
+	std::cout << ok << " " << same(j, ref) << std::endl;
+}
+
+void TestFromPairs()
+{
+	std::cout << "Testing from_pairs..." << std::endl;
+	std::mt19937 rng(20261019);
+	const size_t rows = N / 100;
+	sjtu::vector<sjtu::pair<size_t, int>> pairs;
+	std::vector<std::vector<int>> ref(rows);
+	for (int i = 0; i < N; ++i) {
+		// some rows stay empty
+		size_t r = rng() % (rows / 2) * 2;
+		pairs.push_back(sjtu::pair<size_t, int>(r, i));
+		ref[r].push_back(i);
+	}
+	sjtu::jagged_vector<int> j = sjtu::jagged_vector<int>::from_pairs(rows, pairs);
+	std::cout << same(j, ref) << " " << j.row_size(1) << std::endl;
+	sjtu::jagged_vector<int> e = sjtu::jagged_vector<int>::from_pairs(3, sjtu::vector<sjtu::pair<size_t, int>>());
+	std::cout << e.rows() << " " << e.size() << std::endl;
+	pairs.push_back(sjtu::pair<size_t, int>(rows, 0));
+	try {
+		sjtu::jagged_vector<int>::from_pairs(rows, pairs);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "row out of bound" << std::endl;
+	}
+}
+
+int main()
+{
+	TestRows();
+	TestRandom();
+	TestFromPairs();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,109 @@
+#include "static_index.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+
+const int N = 200000;
+
+// copying it throws once the budget runs out
+struct Key {
+	static int budget;
+	static int alive;
+	std::string s;
+	Key(const std::string &s) : s(s) {
+		++alive;
+	}
+	Key(const Key &other) : s(other.s) {
+		if (budget-- == 0) throw std::string("copy failed");
+		++alive;
+	}
+	~Key() {
+		--alive;
+	}
+	bool operator<(const Key &rhs) const {
+		return s < rhs.s;
+	}
+};
+
+int Key::budget = -1;
+int Key::alive = 0;
+
+void TestQueries()
+{
+	std::cout << "Testing lower_bound and upper_bound..." << std::endl;
+	std::mt19937 rng(20261019);
+	sjtu::vector<int> sorted;
+	for (int i = 0; i < N; ++i) {
+		sorted.push_back(rng() % (4 * N));
+	}
+	std::sort(sorted.begin(), sorted.end());
+	sjtu::static_index<int> idx(sorted);
+	bool ok = idx.size() == sorted.size();
+	int found = 0;
+	for (int i = 0; i < N; ++i) {
+		int x = rng() % (4 * N + 2) - 1;
+		size_t lb = std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin();
+		size_t ub = std::upper_bound(sorted.begin(), sorted.end(), x) - sorted.begin();
+		if (idx.lower_bound(x) != lb || idx.upper_bound(x) != ub) ok = false;
+		if (idx.contains(x) != (lb != ub)) ok = false;
+		found += idx.contains(x);
+	}
+	for (size_t r = 0; r < sorted.size(); r += 97) {
+		if (idx.at_rank(r) != sorted[r]) ok = false;
+	}
+	std::cout << (ok ? "ok" : "wrong") << " " << found << std::endl;
+	try {
+		idx.at_rank(idx.size());
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound" << std::endl;
+	}
+	sjtu::static_index<int> empty;
+	std::cout << empty.size() << " " << empty.lower_bound(5) << " " << empty.contains(5) << std::endl;
+}
+
+void TestThrowingCopy()
+{
+	std::cout << "Testing a key copy throwing while building..." << std::endl;
+	sjtu::vector<Key> sorted;
+	for (int i = 0; i < 1000; ++i) {
+		sorted.push_back(Key(std::to_string(100000 + i)));
+	}
+	int failures = 0;
+	for (int budget : {0, 1, 500, 999}) {
+		Key::budget = budget;
+		try {
+			sjtu::static_index<Key> idx(sorted);
+		} catch (std::string &) {
+			++failures;
+		}
+	}
+	Key::budget = -1;
+	sjtu::static_index<Key> idx(sorted);
+	for (int budget : {0, 10, 999}) {
+		Key::budget = budget;
+		try {
+			sjtu::static_index<Key> copy(idx);
+		} catch (std::string &) {
+			++failures;
+		}
+		try {
+			sjtu::static_index<Key> other(sorted);
+			Key::budget = budget;
+			other = idx;
+		} catch (std::string &) {
+			++failures;
+		}
+	}
+	Key::budget = -1;
+	std::cout << failures << " " << Key::alive << " " << idx.size() << " " << idx.at_rank(500).s << std::endl;
+}
+
+int main()
+{
+	TestQueries();
+	TestThrowingCopy();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
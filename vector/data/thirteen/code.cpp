@@ -0,0 +1,108 @@
+#include "compressed_int_vector.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+const int N = 1000000;
+
+typedef sjtu::compressed_int_vector Vec;
+
+bool same(const Vec &v, const std::vector<uint64_t> &ref)
+{
+	if (v.size() != ref.size()) return false;
+	size_t i = 0;
+	bool ok = true;
+	v.for_each([&](uint64_t x) { ok = ok && x == ref[i++]; });
+	return ok && i == ref.size();
+}
+
+void TestBasic()
+{
+	std::cout << "Testing basic operations..." << std::endl;
+	Vec v;
+	std::cout << v.empty() << " " << v.size() << " " << v.block_count() << " " << v.lower_bound(5) << std::endl;
+	try {
+		v.back();
+	} catch (sjtu::container_is_empty &) {
+		std::cout << "empty back" << std::endl;
+	}
+	std::vector<uint64_t> ref;
+	// equal values (zero width gaps), then the full 64 bit range
+	for (int i = 0; i < 300; ++i) ref.push_back(7);
+	ref.push_back(UINT64_MAX / 2);
+	for (int i = 0; i < 200; ++i) ref.push_back(UINT64_MAX - 199 + i);
+	for (uint64_t x : ref) v.push_back(x);
+	std::cout << v.size() << " " << v.block_count() << " " << v.back() << " " << same(v, ref) << std::endl;
+	std::cout << v[0] << " " << v[299] << " " << v[300] << " " << v.at(v.size() - 1) << std::endl;
+	std::cout << v.lower_bound(7) << " " << v.lower_bound(8) << " " << v.lower_bound(UINT64_MAX) << std::endl;
+	std::cout << v.contains(7) << v.contains(0) << v.contains(UINT64_MAX) << v.contains(UINT64_MAX - 200) << std::endl;
+	try {
+		v.at(v.size());
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "out of bound" << std::endl;
+	}
+	try {
+		v.push_back(6);
+	} catch (sjtu::runtime_error &) {
+		std::cout << "not sorted " << v.size() << std::endl;
+	}
+	try {
+		uint64_t buf[Vec::BLOCK_SIZE];
+		v.decode_block(v.block_count(), buf);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "no such block" << std::endl;
+	}
+	v.clear();
+	std::cout << v.empty() << " " << v.block_count() << std::endl;
+	v.push_back(1);
+	std::cout << v.size() << " " << v.back() << std::endl;
+}
+
+void TestRandom()
+{
+	std::cout << "Testing random sorted data..." << std::endl;
+	std::mt19937_64 rng(20261019);
+	std::vector<uint64_t> ref;
+	sjtu::vector<uint64_t> sorted;
+	uint64_t x = 0;
+	for (int i = 0; i < N; ++i) {
+		// mostly small gaps, now and then a huge one
+		x += i % 1000 == 0 ? rng() % (uint64_t(1) << 40) : rng() % 64;
+		ref.push_back(x);
+		sorted.push_back(x);
+	}
+	Vec v(sorted);
+	std::cout << same(v, ref) << " " << (v.memory_usage() < N * sizeof(uint64_t) / 2) << std::endl;
+	bool ok = true;
+	for (int i = 0; i < N / 10; ++i) {
+		size_t pos = rng() % N;
+		ok = ok && v[pos] == ref[pos];
+		uint64_t q = rng() % (x + 100);
+		size_t lb = std::lower_bound(ref.begin(), ref.end(), q) - ref.begin();
+		ok = ok && v.lower_bound(q) == lb;
+		ok = ok && v.contains(q) == std::binary_search(ref.begin(), ref.end(), q);
+	}
+	std::cout << ok << std::endl;
+	uint64_t buf[Vec::BLOCK_SIZE];
+	v.decode_block(v.block_count() - 1, buf);
+	size_t last = (v.block_count() - 1) * Vec::BLOCK_SIZE;
+	ok = true;
+	for (size_t i = last; i < v.size(); ++i) ok = ok && buf[i - last] == ref[i];
+	std::cout << ok << std::endl;
+	try {
+		sorted.push_back(0);
+		Vec bad(sorted);
+	} catch (sjtu::runtime_error &) {
+		std::cout << "unsorted input" << std::endl;
+	}
+}
+
+int main()
+{
+	TestBasic();
+	TestRandom();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,128 @@
+#include "radix_sort.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+const int N = 3000000; // above the size where the histograms are counted by several threads
+
+template<typename K>
+concept sortable = requires(sjtu::vector<K> &v) { sjtu::radix_sort(v); };
+
+static_assert(sortable<int> && sortable<unsigned char> && sortable<long long> && sortable<float> && sortable<double>);
+static_assert(!sortable<bool> && !sortable<long double> && !sortable<std::string>);
+
+struct Record {
+	int key;
+	int order;
+	std::string name;
+	double weight() const {
+		return -key * 0.5;
+	}
+};
+
+template<typename K>
+bool check(sjtu::vector<K> v)
+{
+	sjtu::vector<K> ref = v;
+	sjtu::radix_sort(v);
+	std::sort(ref.begin(), ref.end());
+	for (size_t i = 0; i < v.size(); ++i) {
+		if (!(v[i] == ref[i])) return false;
+	}
+	return true;
+}
+
+void TestNumbers()
+{
+	std::cout << "Testing radix_sort..." << std::endl;
+	std::mt19937_64 rng(20261019);
+	sjtu::vector<int> a;
+	sjtu::vector<unsigned char> b;
+	sjtu::vector<long long> c;
+	sjtu::vector<double> d;
+	sjtu::vector<float> e;
+	for (int i = 0; i < N; ++i) {
+		a.push_back(int(rng()));
+		c.push_back(i % 2 ? (long long)rng() : (long long)(rng() % 1000) - 500);
+		d.push_back(std::ldexp(double(int64_t(rng())), int(rng() % 200) - 100));
+	}
+	for (int i = 0; i < 100000; ++i) {
+		b.push_back((unsigned char)rng());
+		e.push_back(float(int(rng() % 2001) - 1000) / 7);
+	}
+	std::cout << check(a) << check(b) << check(c) << check(d) << check(e) << std::endl;
+
+	sjtu::vector<double> special;
+	for (double x : {0.0, -1.5, std::numeric_limits<double>::infinity(), -0.0, 2.25,
+	                 -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::denorm_min(), -2.25}) {
+		special.push_back(x);
+	}
+	sjtu::radix_sort(special);
+	for (double x : special) {
+		std::cout << (std::signbit(x) ? "-" : "+") << std::fabs(x) << " ";
+	}
+	std::cout << std::endl;
+	sjtu::vector<int> small;
+	sjtu::radix_sort(small);
+	small.push_back(3);
+	sjtu::radix_sort(small);
+	std::cout << small.size() << " " << small[0] << std::endl;
+}
+
+void TestByKey()
+{
+	std::cout << "Testing sort_by_key..." << std::endl;
+	std::mt19937 rng(20261019);
+	sjtu::vector<Record> v;
+	for (int i = 0; i < N / 10; ++i) {
+		v.push_back(Record{int(rng() % 1000) - 500, i, "record " + std::to_string(i)});
+	}
+	auto stable = [](const sjtu::vector<Record> &r, bool ascending) {
+		for (size_t i = 1; i < r.size(); ++i) {
+			int a = ascending ? r[i - 1].key : r[i].key, b = ascending ? r[i].key : r[i - 1].key;
+			if (a > b || (r[i - 1].key == r[i].key && r[i - 1].order > r[i].order)) return false;
+			if (r[i].name != "record " + std::to_string(r[i].order)) return false;
+		}
+		return true;
+	};
+	// by a lambda, then by a pointer to a data member, then by a const member function
+	sjtu::vector<Record> w = v;
+	int calls = 0;
+	sjtu::sort_by_key(w, [&](const Record &r) {
+		++calls;
+		return r.key;
+	});
+	std::cout << stable(w, true) << " " << (calls == (int)v.size()) << std::endl;
+	w = v;
+	sjtu::sort_by_key(w, &Record::key);
+	std::cout << stable(w, true) << std::endl;
+	w = v;
+	sjtu::sort_by_key(w, &Record::weight);
+	std::cout << stable(w, false) << std::endl;
+	// a throwing key function leaves the vector as it was
+	w = v;
+	try {
+		sjtu::sort_by_key(w, [](const Record &r) {
+			if (r.order == 1000) throw std::string("key failed");
+			return r.key;
+		});
+	} catch (std::string &) {
+		bool same = w.size() == v.size();
+		for (size_t i = 0; same && i < w.size(); ++i) {
+			same = w[i].order == v[i].order && w[i].name == v[i].name;
+		}
+		std::cout << "unchanged " << same << std::endl;
+	}
+}
+
+int main()
+{
+	TestNumbers();
+	TestByKey();
+	std::cout << "Congratulations. Your submission has passed all correctness tests. Good Job!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,245 @@
+#ifndef SJTU_COMPRESSED_INT_VECTOR_HPP
+#define SJTU_COMPRESSED_INT_VECTOR_HPP
+
+#include "vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace sjtu {
+
+namespace compressed_detail {
+
+constexpr size_t BLOCK_SIZE = 128;
+
+using unpacker = void (*)(const uint64_t *, uint64_t *);
+
+// unpack BLOCK_SIZE gaps of B bits each
+template<unsigned B>
+void unpack(const uint64_t *in, uint64_t *out) {
+    if constexpr (B == 0) {
+        std::fill(out, out + BLOCK_SIZE, uint64_t(0));
+    } else {
+        constexpr uint64_t mask = B == 64 ? ~uint64_t(0) : (uint64_t(1) << B) - 1;
+#pragma GCC unroll 128
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            size_t pos = i * B, w = pos / 64, s = pos % 64;
+            uint64_t v = in[w] >> s;
+            if (s + B > 64) v |= in[w + 1] << (64 - s);
+            out[i] = v & mask;
+        }
+    }
+}
+
+template<size_t... B>
+constexpr std::array<unpacker, sizeof...(B)> make_unpackers(std::index_sequence<B...>) {
+    return {&unpack<B>...};
+}
+
+// unpackers[b] decodes a block packed with b bits per gap
+constexpr std::array<unpacker, 65> unpackers = make_unpackers(std::make_index_sequence<65>());
+
+} // namespace compressed_detail
+
+/**
+ * a compressed vector of sorted (non-decreasing) 64-bit integers.
+ *
+ * values are grouped in blocks of 128. Every full block stores the gaps
+ * between neighbouring values, bit-packed with the width of its largest gap
+ * (frame of reference), and a skip table keeps the first value of every
+ * block and where its words start. The last, incomplete block is kept
+ * uncompressed until it fills up.
+ *
+ * operator[] decodes a single block and lower_bound binary searches the
+ * skip table before decoding one block. The decoder is instantiated for
+ * each bit width so that the shifts are constants and the compiler can
+ * unroll and vectorize it.
+ */
+class compressed_int_vector {
+  public:
+    static constexpr size_t BLOCK_SIZE = compressed_detail::BLOCK_SIZE;
+
+  private:
+    struct block_header {
+        uint64_t first;  // the first value of the block
+        size_t   offset; // index of the first packed word in _m_words
+        unsigned bits;   // width of every packed gap, the block takes 2 * bits words
+    };
+
+    vector<uint64_t>     _m_words;
+    vector<block_header> _m_skip;
+    uint64_t             _m_tail[BLOCK_SIZE];
+    size_t               _m_tail_size;
+
+  public:
+    /**
+     * constructors
+     */
+    compressed_int_vector() : _m_tail_size(0) {}
+    /**
+     * compress a sorted vector,
+     * throw runtime_error if it is not sorted.
+     */
+    explicit compressed_int_vector(const vector<uint64_t> &sorted) : _m_tail_size(0) {
+        for (size_t i = 0; i < sorted.size(); ++i) push_back(sorted[i]);
+    }
+    /**
+     * returns the number of elements
+     */
+    size_t size() const {
+        return _m_skip.size() * BLOCK_SIZE + _m_tail_size;
+    }
+    /**
+     * checks whether the container is empty
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+    /**
+     * the number of bytes used by the compressed data and the skip table.
+     */
+    size_t memory_usage() const {
+        return sizeof(*this) + _m_words.capacity() * sizeof(uint64_t)
+               + _m_skip.capacity() * sizeof(block_header);
+    }
+    /**
+     * returns the element at pos, decoding the block containing it.
+     * throw index_out_of_bound if pos is not in [0, size)
+     */
+    uint64_t at(size_t pos) const {
+        if (pos >= size()) throw index_out_of_bound();
+        size_t blk = pos / BLOCK_SIZE;
+        if (blk == _m_skip.size()) return _m_tail[pos % BLOCK_SIZE];
+        uint64_t buf[BLOCK_SIZE];
+        decode_block(blk, buf);
+        return buf[pos % BLOCK_SIZE];
+    }
+    uint64_t operator[](size_t pos) const {
+        return at(pos);
+    }
+    /**
+     * access the last element.
+     * throw container_is_empty if size == 0
+     */
+    uint64_t back() const {
+        if (empty()) throw container_is_empty();
+        return at(size() - 1);
+    }
+    /**
+     * adds an element to the end.
+     * throw runtime_error if value is less than the last element.
+     */
+    void push_back(uint64_t value) {
+        if (_m_tail_size > 0) {
+            if (value < _m_tail[_m_tail_size - 1]) throw runtime_error();
+        } else if (!_m_skip.empty() && value < back()) {
+            throw runtime_error();
+        }
+        _m_tail[_m_tail_size++] = value;
+        if (_m_tail_size == BLOCK_SIZE) _flush_tail();
+    }
+    /**
+     * returns the index of the first element which is not less than x,
+     * returns size() if there is no such element.
+     */
+    size_t lower_bound(uint64_t x) const {
+        // the last block whose first value is less than x is the only candidate
+        size_t lo = 0, hi = _m_skip.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (_m_skip[mid].first < x) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo > 0) {
+            uint64_t buf[BLOCK_SIZE];
+            decode_block(lo - 1, buf);
+            size_t in = std::lower_bound(buf, buf + BLOCK_SIZE, x) - buf;
+            if (in < BLOCK_SIZE) return (lo - 1) * BLOCK_SIZE + in;
+        }
+        if (lo < _m_skip.size()) return lo * BLOCK_SIZE;
+        return _m_skip.size() * BLOCK_SIZE + (std::lower_bound(_m_tail, _m_tail + _m_tail_size, x) - _m_tail);
+    }
+    /**
+     * checks whether x is in the vector
+     */
+    bool contains(uint64_t x) const {
+        size_t pos = lower_bound(x);
+        return pos < size() && at(pos) == x;
+    }
+    /**
+     * the number of blocks, including the incomplete last one.
+     */
+    size_t block_count() const {
+        return _m_skip.size() + (_m_tail_size > 0);
+    }
+    /**
+     * decode block blk into out[0, BLOCK_SIZE),
+     *   the last block only fills size() % BLOCK_SIZE elements if it is incomplete.
+     * throw index_out_of_bound if blk is not in [0, block_count())
+     */
+    void decode_block(size_t blk, uint64_t *out) const {
+        if (blk >= block_count()) throw index_out_of_bound();
+        if (blk == _m_skip.size()) {
+            std::copy(_m_tail, _m_tail + _m_tail_size, out);
+            return;
+        }
+        const block_header &h = _m_skip[blk];
+        compressed_detail::unpackers[h.bits](_m_words.data() + h.offset, out);
+        uint64_t sum = h.first;
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            sum += out[i];
+            out[i] = sum;
+        }
+    }
+    /**
+     * call f(value) for every element in order, one block at a time.
+     */
+    template<typename F>
+    void for_each(F f) const {
+        uint64_t buf[BLOCK_SIZE];
+        for (size_t blk = 0; blk < _m_skip.size(); ++blk) {
+            decode_block(blk, buf);
+            for (size_t i = 0; i < BLOCK_SIZE; ++i) f(buf[i]);
+        }
+        for (size_t i = 0; i < _m_tail_size; ++i) f(_m_tail[i]);
+    }
+    /**
+     * clears the contents
+     */
+    void clear() {
+        _m_words.clear();
+        _m_skip.clear();
+        _m_tail_size = 0;
+    }
+
+  private:
+    // compress the full tail into a new block
+    void _flush_tail() {
+        uint64_t gap[BLOCK_SIZE];
+        uint64_t widest = 0;
+        gap[0] = 0;
+        for (size_t i = 1; i < BLOCK_SIZE; ++i) {
+            gap[i] = _m_tail[i] - _m_tail[i - 1];
+            widest |= gap[i];
+        }
+        unsigned bits = std::bit_width(widest);
+        _m_skip.push_back({_m_tail[0], _m_words.size(), bits});
+        size_t base = _m_words.size();
+        for (size_t i = 0; i < 2 * bits; ++i) _m_words.push_back(0);
+        uint64_t *words = _m_words.data() + base;
+        for (size_t i = 0; bits > 0 && i < BLOCK_SIZE; ++i) {
+            size_t pos = i * bits, w = pos / 64, s = pos % 64;
+            words[w] |= gap[i] << s;
+            if (s + bits > 64) words[w + 1] |= gap[i] >> (64 - s);
+        }
+        _m_tail_size = 0;
+    }
+};
+
+}
+
+#endif
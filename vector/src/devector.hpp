@@ -0,0 +1,441 @@
+#ifndef SJTU_DEVECTOR_HPP
+#define SJTU_DEVECTOR_HPP
+
+#include "vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace sjtu {
+/**
+ * a contiguous sequence with spare capacity at both ends of its buffer,
+ * so push_front / pop_front are amortized O(1) like push_back / pop_back,
+ * and [data(), data() + size()) is still a single array.
+ *
+ * when the end that is pushed runs out of room the elements are moved to the
+ * middle of a new buffer, twice as large if at least half of the old one was
+ * in use, so both ends have spare room again (recentering).
+ * The iterators wrap a pointer into the buffer, they are invalidated by any reallocation.
+ */
+template<typename T>
+class devector {
+  private:
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    T     *_m_buf;
+    size_t _m_cap;
+    size_t _m_begin; // index of the first element in _m_buf
+    size_t _m_size;
+    std::allocator<T> _alloc;
+
+  public:
+    class const_iterator;
+    class iterator {
+      public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
+        friend class devector;
+
+      private:
+        T              *_m_ptr;
+        const devector *_dv;
+        iterator(T *ptr, const devector *dv) : _m_ptr(ptr), _dv(dv) {}
+
+      public:
+        iterator() : _m_ptr(nullptr), _dv(nullptr) {}
+        iterator operator+(const difference_type &n) const {
+            return iterator(_m_ptr + n, _dv);
+        }
+        friend iterator operator+(const difference_type &n, const iterator &it) {
+            return it + n;
+        }
+        iterator operator-(const difference_type &n) const {
+            return iterator(_m_ptr - n, _dv);
+        }
+        // throw invalid_iterator if the iterators belong to different devectors
+        difference_type operator-(const iterator &rhs) const {
+            if (_dv != rhs._dv) throw invalid_iterator();
+            return _m_ptr - rhs._m_ptr;
+        }
+        iterator &operator+=(const difference_type &n) {
+            _m_ptr += n;
+            return *this;
+        }
+        iterator &operator-=(const difference_type &n) {
+            _m_ptr -= n;
+            return *this;
+        }
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++_m_ptr;
+            return tmp;
+        }
+        iterator &operator++() {
+            ++_m_ptr;
+            return *this;
+        }
+        iterator operator--(int) {
+            auto tmp = *this;
+            --_m_ptr;
+            return tmp;
+        }
+        iterator &operator--() {
+            --_m_ptr;
+            return *this;
+        }
+        T &operator*() const {
+            return *_m_ptr;
+        }
+        T *operator->() const {
+            return _m_ptr;
+        }
+        T &operator[](const difference_type &n) const {
+            return _m_ptr[n];
+        }
+        bool operator==(const iterator &rhs) const {
+            return _m_ptr == rhs._m_ptr;
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return _m_ptr == rhs._m_cptr;
+        }
+        auto operator<=>(const iterator &rhs) const {
+            return _m_ptr <=> rhs._m_ptr;
+        }
+    };
+    class const_iterator {
+      public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
+        friend class devector;
+
+      private:
+        const T        *_m_cptr;
+        const devector *_dv;
+        const_iterator(const T *ptr, const devector *dv) : _m_cptr(ptr), _dv(dv) {}
+
+      public:
+        const_iterator() : _m_cptr(nullptr), _dv(nullptr) {}
+        const_iterator(const iterator &other) : _m_cptr(other._m_ptr), _dv(other._dv) {}
+        const_iterator operator+(const difference_type &n) const {
+            return const_iterator(_m_cptr + n, _dv);
+        }
+        friend const_iterator operator+(const difference_type &n, const const_iterator &it) {
+            return it + n;
+        }
+        const_iterator operator-(const difference_type &n) const {
+            return const_iterator(_m_cptr - n, _dv);
+        }
+        difference_type operator-(const const_iterator &rhs) const {
+            if (_dv != rhs._dv) throw invalid_iterator();
+            return _m_cptr - rhs._m_cptr;
+        }
+        const_iterator &operator+=(const difference_type &n) {
+            _m_cptr += n;
+            return *this;
+        }
+        const_iterator &operator-=(const difference_type &n) {
+            _m_cptr -= n;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            ++_m_cptr;
+            return tmp;
+        }
+        const_iterator &operator++() {
+            ++_m_cptr;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto tmp = *this;
+            --_m_cptr;
+            return tmp;
+        }
+        const_iterator &operator--() {
+            --_m_cptr;
+            return *this;
+        }
+        const T &operator*() const {
+            return *_m_cptr;
+        }
+        const T *operator->() const {
+            return _m_cptr;
+        }
+        const T &operator[](const difference_type &n) const {
+            return _m_cptr[n];
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return _m_cptr == rhs._m_cptr;
+        }
+        auto operator<=>(const const_iterator &rhs) const {
+            return _m_cptr <=> rhs._m_cptr;
+        }
+    };
+    /**
+     * constructors
+     */
+    devector() : _m_buf(nullptr), _m_cap(0), _m_begin(0), _m_size(0) {}
+    devector(const devector &other) : _m_buf(nullptr), _m_cap(0), _m_begin(0), _m_size(0) {
+        if (other._m_size == 0) return;
+        _m_cap = other._m_size;
+        _m_buf = _alloc.allocate(_m_cap);
+        for (; _m_size < other._m_size; ++_m_size) std::construct_at(_m_buf + _m_size, other[_m_size]);
+    }
+    devector(devector &&other) noexcept
+        : _m_buf(other._m_buf), _m_cap(other._m_cap), _m_begin(other._m_begin), _m_size(other._m_size) {
+        other._m_buf = nullptr;
+        other._m_cap = other._m_begin = other._m_size = 0;
+    }
+    /**
+     * destructor
+     */
+    ~devector() {
+        clear();
+        if (_m_buf) _alloc.deallocate(_m_buf, _m_cap);
+    }
+    /**
+     * assignment operators
+     */
+    devector &operator=(const devector &other) {
+        if (this == &other) return *this;
+        devector tmp(other);
+        return *this = std::move(tmp);
+    }
+    devector &operator=(devector &&other) noexcept {
+        if (this == &other) return *this;
+        clear();
+        if (_m_buf) _alloc.deallocate(_m_buf, _m_cap);
+        _m_buf = other._m_buf;
+        _m_cap = other._m_cap;
+        _m_begin = other._m_begin;
+        _m_size = other._m_size;
+        other._m_buf = nullptr;
+        other._m_cap = other._m_begin = other._m_size = 0;
+        return *this;
+    }
+    /**
+     * assigns specified element with bounds checking
+     * throw index_out_of_bound if pos is not in [0, size)
+     */
+    T &at(const size_t &pos) {
+        if (pos >= _m_size) throw index_out_of_bound();
+        return _m_buf[_m_begin + pos];
+    }
+    const T &at(const size_t &pos) const {
+        if (pos >= _m_size) throw index_out_of_bound();
+        return _m_buf[_m_begin + pos];
+    }
+    T &operator[](const size_t &pos) {
+        return at(pos);
+    }
+    const T &operator[](const size_t &pos) const {
+        return at(pos);
+    }
+    /**
+     * access the first / last element.
+     * throw container_is_empty if size == 0
+     */
+    const T &front() const {
+        if (_m_size == 0) throw container_is_empty();
+        return _m_buf[_m_begin];
+    }
+    const T &back() const {
+        if (_m_size == 0) throw container_is_empty();
+        return _m_buf[_m_begin + _m_size - 1];
+    }
+    /**
+     * returns a pointer to the first element,
+     * the elements are stored successively in [data(), data() + size()).
+     */
+    T *data() {
+        return _m_buf + _m_begin;
+    }
+    const T *data() const {
+        return _m_buf + _m_begin;
+    }
+    /**
+     * iterators to the beginning and the end.
+     */
+    iterator begin() {
+        return iterator(data(), this);
+    }
+    const_iterator begin() const {
+        return const_iterator(data(), this);
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    iterator end() {
+        return iterator(data() + _m_size, this);
+    }
+    const_iterator end() const {
+        return const_iterator(data() + _m_size, this);
+    }
+    const_iterator cend() const {
+        return end();
+    }
+    /**
+     * checks whether the container is empty
+     */
+    bool empty() const {
+        return _m_size == 0;
+    }
+    /**
+     * returns the number of elements
+     */
+    size_t size() const {
+        return _m_size;
+    }
+    /**
+     * returns the size of the buffer, and the free slots before / after the elements.
+     */
+    size_t capacity() const {
+        return _m_cap;
+    }
+    size_t front_capacity() const {
+        return _m_begin;
+    }
+    size_t back_capacity() const {
+        return _m_cap - _m_begin - _m_size;
+    }
+    /**
+     * clears the contents, the buffer is kept.
+     */
+    void clear() {
+        for (size_t i = 0; i < _m_size; ++i) std::destroy_at(_m_buf + _m_begin + i);
+        _m_begin = _m_cap / 2;
+        _m_size = 0;
+    }
+    /**
+     * inserts value at index ind, moving the shorter side.
+     * returns an iterator pointing to the inserted value.
+     * throw index_out_of_bound if ind > size
+     */
+    iterator insert(const size_t &ind, const T &value) {
+        if (ind > _m_size) throw index_out_of_bound();
+        T tmp(value); // value may be an element of this container
+        size_t n = _m_size;
+        if (ind == 0) {
+            push_front(std::move(tmp));
+        } else if (ind == n) {
+            push_back(std::move(tmp));
+        } else if (ind < n - ind) {
+            // a new first element, then shift [1, ind) one step to the front
+            emplace_front(std::move(data()[0]));
+            T *p = data();
+            std::move(p + 2, p + ind + 1, p + 1);
+            p[ind] = std::move(tmp);
+        } else {
+            emplace_back(std::move(data()[n - 1]));
+            T *p = data();
+            std::move_backward(p + ind, p + n - 1, p + n);
+            p[ind] = std::move(tmp);
+        }
+        return begin() + ind;
+    }
+    iterator insert(iterator pos, const T &value) {
+        return insert(pos - begin(), value);
+    }
+    /**
+     * removes the element with index ind, moving the shorter side.
+     * return an iterator pointing to the following element.
+     * throw index_out_of_bound if ind >= size
+     */
+    iterator erase(const size_t &ind) {
+        if (ind >= _m_size) throw index_out_of_bound();
+        T *p = data();
+        if (ind < _m_size - 1 - ind) {
+            for (size_t i = ind; i > 0; --i) p[i] = std::move(p[i - 1]);
+            pop_front();
+        } else {
+            for (size_t i = ind; i + 1 < _m_size; ++i) p[i] = std::move(p[i + 1]);
+            pop_back();
+        }
+        return begin() + ind;
+    }
+    iterator erase(iterator pos) {
+        return erase(pos - begin());
+    }
+    /**
+     * adds an element to the beginning / end, amortized O(1).
+     */
+    void push_front(const T &value) {
+        emplace_front(value);
+    }
+    void push_front(T &&value) {
+        emplace_front(std::move(value));
+    }
+    void push_back(const T &value) {
+        emplace_back(value);
+    }
+    void push_back(T &&value) {
+        emplace_back(std::move(value));
+    }
+    template<typename... Args>
+    T &emplace_front(Args &&...args) {
+        if (_m_begin == 0) {
+            T tmp(std::forward<Args>(args)...); // args may refer to an element
+            _recenter();
+            std::construct_at(_m_buf + _m_begin - 1, std::move(tmp));
+        } else {
+            std::construct_at(_m_buf + _m_begin - 1, std::forward<Args>(args)...);
+        }
+        --_m_begin;
+        ++_m_size;
+        return _m_buf[_m_begin];
+    }
+    template<typename... Args>
+    T &emplace_back(Args &&...args) {
+        if (_m_begin + _m_size == _m_cap) {
+            T tmp(std::forward<Args>(args)...);
+            _recenter();
+            std::construct_at(_m_buf + _m_begin + _m_size, std::move(tmp));
+        } else {
+            std::construct_at(_m_buf + _m_begin + _m_size, std::forward<Args>(args)...);
+        }
+        return _m_buf[_m_begin + _m_size++];
+    }
+    /**
+     * remove the first / last element, O(1).
+     * throw container_is_empty if size() == 0
+     */
+    void pop_front() {
+        if (_m_size == 0) throw container_is_empty();
+        std::destroy_at(_m_buf + _m_begin);
+        ++_m_begin;
+        --_m_size;
+    }
+    void pop_back() {
+        if (_m_size == 0) throw container_is_empty();
+        std::destroy_at(_m_buf + _m_begin + --_m_size);
+    }
+
+  private:
+    // move the elements to the middle of a new buffer, doubled if it is at least half full.
+    // both ends get at least cap / 4 free slots, which pays for the moves.
+    void _recenter() {
+        size_t cap = _m_size * 2 >= _m_cap ? max(_m_cap * 2, MIN_CAPACITY) : _m_cap;
+        T *buf = _alloc.allocate(cap);
+        size_t begin = (cap - _m_size) / 2;
+        relocate_n(_m_buf + _m_begin, _m_size, buf + begin);
+        if (_m_buf) _alloc.deallocate(_m_buf, _m_cap);
+        _m_buf = buf;
+        _m_cap = cap;
+        _m_begin = begin;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,468 @@
+#ifndef SJTU_HIVE_HPP
+#define SJTU_HIVE_HPP
+
+#include "exceptions.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace sjtu {
+/**
+ * an unordered container with O(1) insert and erase whose elements never move,
+ * so pointers and iterators stay valid until that element is erased (a colony).
+ *
+ * the elements live in a list of blocks of growing size (MIN_BLOCK to MAX_BLOCK).
+ * An erased slot is not filled by moving other elements, instead
+ *  - every block has a skip field, where a run of L erased slots [s, s + L)
+ *    has skip[s] == skip[s + L - 1] == L and a live slot has skip == 0,
+ *    so iterating jumps over a run of holes in O(1) (in both directions);
+ *  - the starts of the runs form a free list inside the erased slots,
+ *    and insert takes the first slot of a run before growing.
+ * A block which becomes empty is released, except the last one.
+ */
+template<typename T>
+class hive {
+  private:
+    static constexpr size_t MIN_BLOCK = 8;
+    static constexpr size_t MAX_BLOCK = 8192;
+    static constexpr uint16_t NONE = UINT16_MAX;
+
+    struct free_links {
+        uint16_t prev, next;
+    };
+    // an element, or the free list links if it starts a run of erased slots
+    union slot {
+        T          value;
+        free_links links;
+        slot() {}
+        ~slot() {}
+    };
+    struct block {
+        slot     *slots;
+        uint16_t *skip;      // cap + 1 entries, skip[high] stays 0
+        size_t    cap;
+        size_t    high;      // slots [high, cap) have never been used
+        size_t    size;      // live elements
+        uint16_t  free_head; // first run of erased slots, NONE if there is none
+        block    *prev, *next;
+        block    *prev_free, *next_free; // the blocks with erased slots
+    };
+
+    block *_m_head;
+    block *_m_tail;
+    block *_m_free_blocks;
+    size_t _m_size;
+    size_t _m_cap;
+    std::allocator<slot>     _alloc;
+    std::allocator<uint16_t> _skip_alloc;
+
+  public:
+    class const_iterator;
+    class iterator {
+      public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::bidirectional_iterator_tag;
+        friend class hive;
+
+      private:
+        block      *_b; // nullptr for end()
+        size_t      _i;
+        const hive *_h;
+        iterator(block *b, size_t i, const hive *h) : _b(b), _i(i), _h(h) {}
+
+      public:
+        iterator() : _b(nullptr), _i(0), _h(nullptr) {}
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        iterator &operator++() {
+            hive::_next(_b, _i);
+            return *this;
+        }
+        iterator operator--(int) {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+        iterator &operator--() {
+            _h->_prev(_b, _i);
+            return *this;
+        }
+        T &operator*() const {
+            return _b->slots[_i].value;
+        }
+        T *operator->() const {
+            return &_b->slots[_i].value;
+        }
+        bool operator==(const iterator &rhs) const {
+            return _b == rhs._b && _i == rhs._i;
+        }
+        bool operator!=(const iterator &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+    class const_iterator {
+      public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::bidirectional_iterator_tag;
+        friend class hive;
+
+      private:
+        block      *_b;
+        size_t      _i;
+        const hive *_h;
+        const_iterator(block *b, size_t i, const hive *h) : _b(b), _i(i), _h(h) {}
+
+      public:
+        const_iterator() : _b(nullptr), _i(0), _h(nullptr) {}
+        const_iterator(const iterator &other) : _b(other._b), _i(other._i), _h(other._h) {}
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        const_iterator &operator++() {
+            hive::_next(_b, _i);
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+        const_iterator &operator--() {
+            _h->_prev(_b, _i);
+            return *this;
+        }
+        const T &operator*() const {
+            return _b->slots[_i].value;
+        }
+        const T *operator->() const {
+            return &_b->slots[_i].value;
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return _b == rhs._b && _i == rhs._i;
+        }
+        bool operator!=(const const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+    /**
+     * constructors
+     */
+    hive() : _m_head(nullptr), _m_tail(nullptr), _m_free_blocks(nullptr), _m_size(0), _m_cap(0) {}
+    hive(const hive &other) : hive() {
+        for (const T &x : other) insert(x);
+    }
+    hive(hive &&other) noexcept
+        : _m_head(other._m_head), _m_tail(other._m_tail), _m_free_blocks(other._m_free_blocks),
+          _m_size(other._m_size), _m_cap(other._m_cap) {
+        other._m_head = other._m_tail = other._m_free_blocks = nullptr;
+        other._m_size = other._m_cap = 0;
+    }
+    /**
+     * destructor
+     */
+    ~hive() {
+        clear();
+    }
+    /**
+     * assignment operators
+     */
+    hive &operator=(const hive &other) {
+        if (this == &other) return *this;
+        clear();
+        for (const T &x : other) insert(x);
+        return *this;
+    }
+    hive &operator=(hive &&other) noexcept {
+        if (this == &other) return *this;
+        clear();
+        _m_head = other._m_head;
+        _m_tail = other._m_tail;
+        _m_free_blocks = other._m_free_blocks;
+        _m_size = other._m_size;
+        _m_cap = other._m_cap;
+        other._m_head = other._m_tail = other._m_free_blocks = nullptr;
+        other._m_size = other._m_cap = 0;
+        return *this;
+    }
+    /**
+     * iterators to the beginning and the end, in block order.
+     */
+    iterator begin() {
+        block *b = _m_head;
+        size_t i = b ? b->skip[0] : 0;
+        _skip_done_blocks(b, i);
+        return iterator(b, i, this);
+    }
+    const_iterator begin() const {
+        return const_cast<hive *>(this)->begin();
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    iterator end() {
+        return iterator(nullptr, 0, this);
+    }
+    const_iterator end() const {
+        return const_iterator(nullptr, 0, this);
+    }
+    const_iterator cend() const {
+        return end();
+    }
+    /**
+     * checks whether the container is empty
+     */
+    bool empty() const {
+        return _m_size == 0;
+    }
+    /**
+     * returns the number of elements / slots in all the blocks
+     */
+    size_t size() const {
+        return _m_size;
+    }
+    size_t capacity() const {
+        return _m_cap;
+    }
+    /**
+     * clears the contents and releases every block
+     */
+    void clear() {
+        for (block *b = _m_head; b;) {
+            block *nxt = b->next;
+            for (size_t i = 0; i < b->high; ++i) {
+                if (!b->skip[i]) std::destroy_at(&b->slots[i].value);
+            }
+            _free_block(b);
+            b = nxt;
+        }
+        _m_head = _m_tail = _m_free_blocks = nullptr;
+        _m_size = _m_cap = 0;
+    }
+    /**
+     * inserts an element in O(1), reusing an erased slot if there is one.
+     * returns an iterator pointing to it.
+     */
+    iterator insert(const T &value) {
+        return emplace(value);
+    }
+    iterator insert(T &&value) {
+        return emplace(std::move(value));
+    }
+    template<typename... Args>
+    iterator emplace(Args &&...args) {
+        if (_m_free_blocks) {
+            block *b = _m_free_blocks;
+            size_t s = b->free_head, len = b->skip[s];
+            free_links lk = b->slots[s].links;
+            try {
+                std::construct_at(&b->slots[s].value, std::forward<Args>(args)...);
+            } catch (...) {
+                std::construct_at(&b->slots[s].links, lk);
+                throw;
+            }
+            // the run [s, s + len) becomes [s + 1, s + len)
+            b->skip[s] = 0;
+            if (len == 1) {
+                _unlink_run(b, lk);
+            } else {
+                b->skip[s + 1] = b->skip[s + len - 1] = len - 1;
+                _move_run(b, lk, s + 1);
+            }
+            ++b->size;
+            ++_m_size;
+            return iterator(b, s, this);
+        }
+        if (!_m_tail || _m_tail->high == _m_tail->cap) {
+            size_t cap = _m_cap < MIN_BLOCK ? MIN_BLOCK : _m_cap > MAX_BLOCK ? MAX_BLOCK : _m_cap;
+            _new_block(cap);
+        }
+        block *b = _m_tail;
+        std::construct_at(&b->slots[b->high].value, std::forward<Args>(args)...);
+        ++b->size;
+        ++_m_size;
+        return iterator(b, b->high++, this);
+    }
+    /**
+     * removes the element at pos in O(1), the other elements are not moved.
+     * return an iterator pointing to the following element.
+     * throw invalid_iterator if pos is end() or belongs to another hive
+     */
+    iterator erase(const_iterator pos) {
+        if (pos._b == nullptr || pos._h != this) throw invalid_iterator();
+        block *b = pos._b;
+        size_t i = pos._i;
+        const_iterator nxt = pos;
+        ++nxt;
+        std::destroy_at(&b->slots[i].value);
+        --_m_size;
+        if (--b->size == 0) {
+            _release_block(b);
+            return iterator(nxt._b, nxt._i, this);
+        }
+        bool left = i > 0 && b->skip[i - 1], right = b->skip[i + 1];
+        if (left && right) {
+            // merge [ls, i) + i + [i + 1, re)
+            size_t llen = b->skip[i - 1], rlen = b->skip[i + 1];
+            _unlink_run(b, b->slots[i + 1].links);
+            size_t len = llen + 1 + rlen;
+            b->skip[i - llen] = b->skip[i + rlen] = len;
+            b->skip[i] = len;
+        } else if (left) {
+            size_t llen = b->skip[i - 1];
+            b->skip[i - llen] = b->skip[i] = llen + 1;
+        } else if (right) {
+            size_t rlen = b->skip[i + 1];
+            b->skip[i] = b->skip[i + rlen] = rlen + 1;
+            _move_run(b, b->slots[i + 1].links, i);
+        } else {
+            b->skip[i] = 1;
+            _push_run(b, i);
+        }
+        return iterator(nxt._b, nxt._i, this);
+    }
+    /**
+     * returns an iterator to the element p points to.
+     * throw invalid_iterator if p is not an element of this hive
+     */
+    iterator get_iterator(const T *p) {
+        for (block *b = _m_head; b; b = b->next) {
+            const slot *s = reinterpret_cast<const slot *>(p);
+            if (s >= b->slots && s < b->slots + b->high) {
+                size_t i = s - b->slots;
+                if (b->skip[i]) break;
+                return iterator(b, i, this);
+            }
+        }
+        throw invalid_iterator();
+    }
+
+  private:
+    // step to the next live slot, or (nullptr, 0)
+    static void _next(block *&b, size_t &i) {
+        ++i;
+        i += b->skip[i];
+        _skip_done_blocks(b, i);
+    }
+    static void _skip_done_blocks(block *&b, size_t &i) {
+        while (b && i >= b->high) {
+            b = b->next;
+            i = b ? b->skip[0] : 0;
+        }
+    }
+    // step to the previous live slot, end() steps to the last element.
+    // throw invalid_iterator (leaving b and i unchanged) if it is begin()
+    void _prev(block *&b, size_t &i) const {
+        block *pb = b;
+        size_t pi = i;
+        if (!pb) {
+            pb = _m_tail;
+            pi = pb ? pb->high : 0;
+        }
+        for (;;) {
+            if (!pb) throw invalid_iterator();
+            if (pi == 0) {
+                pb = pb->prev;
+                pi = pb ? pb->high : 0;
+                continue;
+            }
+            --pi;
+            if (!pb->skip[pi]) break;
+            pi = pi + 1 - pb->skip[pi]; // the start of the run
+        }
+        b = pb;
+        i = pi;
+    }
+    void _new_block(size_t cap) {
+        block *b = new block;
+        b->slots = _alloc.allocate(cap);
+        try {
+            b->skip = _skip_alloc.allocate(cap + 1);
+        } catch (...) {
+            _alloc.deallocate(b->slots, cap);
+            delete b;
+            throw;
+        }
+        std::uninitialized_fill_n(b->skip, cap + 1, uint16_t(0));
+        b->cap = cap;
+        b->high = b->size = 0;
+        b->free_head = NONE;
+        b->prev = _m_tail;
+        b->next = nullptr;
+        b->prev_free = b->next_free = nullptr;
+        if (_m_tail) _m_tail->next = b;
+        else _m_head = b;
+        _m_tail = b;
+        _m_cap += cap;
+    }
+    void _free_block(block *b) {
+        _alloc.deallocate(b->slots, b->cap);
+        _skip_alloc.deallocate(b->skip, b->cap + 1);
+        delete b;
+    }
+    // unlink an empty block and free it, the last block is kept for the next inserts
+    void _release_block(block *b) {
+        if (b->free_head != NONE) _remove_free_block(b);
+        b->free_head = NONE;
+        if (b == _m_tail) {
+            std::fill_n(b->skip, b->high, uint16_t(0));
+            b->high = 0;
+            return;
+        }
+        if (b->prev) b->prev->next = b->next;
+        else _m_head = b->next;
+        if (b->next) b->next->prev = b->prev;
+        else _m_tail = b->prev;
+        _m_cap -= b->cap;
+        _free_block(b);
+    }
+    void _remove_free_block(block *b) {
+        if (b->prev_free) b->prev_free->next_free = b->next_free;
+        else _m_free_blocks = b->next_free;
+        if (b->next_free) b->next_free->prev_free = b->prev_free;
+        b->prev_free = b->next_free = nullptr;
+    }
+    // add the run starting at s to the free list of b
+    void _push_run(block *b, size_t s) {
+        std::construct_at(&b->slots[s].links, free_links{NONE, b->free_head});
+        if (b->free_head != NONE) b->slots[b->free_head].links.prev = s;
+        else {
+            b->next_free = _m_free_blocks;
+            if (_m_free_blocks) _m_free_blocks->prev_free = b;
+            _m_free_blocks = b;
+        }
+        b->free_head = s;
+    }
+    // remove the run with links lk from the free list of b
+    void _unlink_run(block *b, free_links lk) {
+        if (lk.prev != NONE) b->slots[lk.prev].links.next = lk.next;
+        else b->free_head = lk.next;
+        if (lk.next != NONE) b->slots[lk.next].links.prev = lk.prev;
+        if (b->free_head == NONE) _remove_free_block(b);
+    }
+    // the run with links lk now starts at s
+    void _move_run(block *b, free_links lk, size_t s) {
+        std::construct_at(&b->slots[s].links, lk);
+        if (lk.prev != NONE) b->slots[lk.prev].links.next = s;
+        else b->free_head = s;
+        if (lk.next != NONE) b->slots[lk.next].links.prev = s;
+    }
+};
+
+}
+
+#endif
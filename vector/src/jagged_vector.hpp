@@ -0,0 +1,179 @@
+#ifndef SJTU_JAGGED_VECTOR_HPP
+#define SJTU_JAGGED_VECTOR_HPP
+
+#include "utility.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <utility>
+
+namespace sjtu {
+/**
+ * a vector of rows of different lengths, like vector<vector<T>>,
+ * flattened into compressed sparse row (CSR) form.
+ *
+ * all the values are stored in one array, row after row, and _m_offsets[i]
+ * is where row i starts (with a final entry for the end), so there are two
+ * allocations in total and a full traversal is one sequential scan.
+ * Rows can only be added / extended at the end.
+ */
+template<typename T>
+class jagged_vector {
+  private:
+    vector<T>      _m_values;
+    vector<size_t> _m_offsets; // rows() + 1 entries, _m_offsets[0] == 0
+
+  public:
+    using iterator = typename vector<T>::iterator;
+    using const_iterator = typename vector<T>::const_iterator;
+    /**
+     * constructors
+     */
+    jagged_vector() {
+        _m_offsets.push_back(0);
+    }
+    /**
+     * build from (row, value) pairs given in any order, with a counting sort
+     * on the row, in O(rows + pairs). The values keep their relative order
+     * inside a row, rows without pairs are empty.
+     * throw index_out_of_bound if some row is not in [0, rows)
+     */
+    static jagged_vector from_pairs(size_t rows, const vector<pair<size_t, T>> &pairs) {
+        jagged_vector res;
+        vector<size_t> &offsets = res._m_offsets;
+        for (size_t i = 0; i < rows; ++i) offsets.push_back(0);
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            if (pairs[i].first >= rows) throw index_out_of_bound();
+            ++offsets[pairs[i].first + 1];
+        }
+        for (size_t i = 0; i < rows; ++i) offsets[i + 1] += offsets[i];
+        // order[k] is the pair whose value goes to position k
+        vector<size_t> order, next;
+        for (size_t i = 0; i < pairs.size(); ++i) order.push_back(0);
+        for (size_t i = 0; i < rows; ++i) next.push_back(offsets[i]);
+        for (size_t i = 0; i < pairs.size(); ++i) order[next[pairs[i].first]++] = i;
+        for (size_t k = 0; k < pairs.size(); ++k) res._m_values.push_back(pairs[order[k]].second);
+        return res;
+    }
+    /**
+     * returns the number of rows / values
+     */
+    size_t rows() const {
+        return _m_offsets.size() - 1;
+    }
+    size_t size() const {
+        return _m_values.size();
+    }
+    /**
+     * checks whether the container has no rows
+     */
+    bool empty() const {
+        return rows() == 0;
+    }
+    /**
+     * returns the values of row i, the span is invalidated by any insertion.
+     * throw index_out_of_bound if i is not in [0, rows)
+     */
+    std::span<T> row(size_t i) {
+        if (i >= rows()) throw index_out_of_bound();
+        return std::span<T>(_m_values.data() + _m_offsets[i], _m_offsets[i + 1] - _m_offsets[i]);
+    }
+    std::span<const T> row(size_t i) const {
+        if (i >= rows()) throw index_out_of_bound();
+        return std::span<const T>(_m_values.data() + _m_offsets[i], _m_offsets[i + 1] - _m_offsets[i]);
+    }
+    std::span<T> operator[](size_t i) {
+        return row(i);
+    }
+    std::span<const T> operator[](size_t i) const {
+        return row(i);
+    }
+    /**
+     * returns the number of values in row i.
+     * throw index_out_of_bound if i is not in [0, rows)
+     */
+    size_t row_size(size_t i) const {
+        if (i >= rows()) throw index_out_of_bound();
+        return _m_offsets[i + 1] - _m_offsets[i];
+    }
+    /**
+     * adds a row with the values of r at the end.
+     */
+    template<std::ranges::input_range R>
+    void push_row(R &&r) {
+        for (auto &&x : r) _m_values.push_back(std::forward<decltype(x)>(x));
+        _m_offsets.push_back(_m_values.size());
+    }
+    /**
+     * adds an empty row at the end.
+     */
+    void push_row() {
+        _m_offsets.push_back(_m_values.size());
+    }
+    /**
+     * appends value to the last row.
+     * throw container_is_empty if there is no row
+     */
+    void push_back(const T &value) {
+        if (empty()) throw container_is_empty();
+        _m_values.push_back(value);
+        ++_m_offsets[rows()];
+    }
+    /**
+     * removes the last row.
+     * throw container_is_empty if there is no row
+     */
+    void pop_row() {
+        if (empty()) throw container_is_empty();
+        size_t start = _m_offsets[rows() - 1];
+        while (_m_values.size() > start) _m_values.pop_back();
+        _m_offsets.pop_back();
+    }
+    /**
+     * iterators over all the values, row after row.
+     */
+    iterator begin() {
+        return _m_values.begin();
+    }
+    const_iterator begin() const {
+        return _m_values.cbegin();
+    }
+    const_iterator cbegin() const {
+        return _m_values.cbegin();
+    }
+    iterator end() {
+        return _m_values.end();
+    }
+    const_iterator end() const {
+        return _m_values.cend();
+    }
+    const_iterator cend() const {
+        return _m_values.cend();
+    }
+    /**
+     * the underlying arrays: all the values, and the rows() + 1 row offsets.
+     */
+    T *data() {
+        return _m_values.data();
+    }
+    const T *data() const {
+        return _m_values.data();
+    }
+    const size_t *offsets() const {
+        return _m_offsets.data();
+    }
+    /**
+     * clears the contents
+     */
+    void clear() {
+        _m_values.clear();
+        _m_offsets.clear();
+        _m_offsets.push_back(0);
+    }
+};
+
+}
+
+#endif
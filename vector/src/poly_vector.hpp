@@ -0,0 +1,535 @@
+#ifndef SJTU_POLY_VECTOR_HPP
+#define SJTU_POLY_VECTOR_HPP
+
+#include "vector.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+
+namespace poly_detail {
+
+// how to move / destroy an object whose type is erased,
+// nullptr means it is trivial (memcpy / nothing)
+struct type_ops {
+    void (*move)(void *dst, void *src);
+    void (*destroy)(void *p);
+};
+
+// construct a D at dst from the one at src, copied if moving could throw.
+// src is not destroyed, so a failed growth can keep the old objects
+template<typename D>
+void move(void *dst, void *src) {
+    std::construct_at(static_cast<D *>(dst), std::move_if_noexcept(*std::launder(static_cast<D *>(src))));
+}
+
+template<typename D>
+void destroy(void *p) {
+    std::destroy_at(std::launder(static_cast<D *>(p)));
+}
+
+// one instance per stored type, its address identifies the type
+template<typename D>
+inline constexpr type_ops ops_for = {
+    std::is_trivially_copyable_v<D> ? nullptr : &move<D>,
+    std::is_trivially_destructible_v<D> ? nullptr : &destroy<D>,
+};
+
+} // namespace poly_detail
+
+/**
+ * a sequence of objects derived from Base, of possibly different sizes.
+ *
+ * the objects are stored inline, one after another, in a single byte arena
+ * and a table keeps where every object and its Base subobject start, so
+ * iterating is a linear scan instead of chasing a vector<Base*> into the heap.
+ * When the arena grows the objects are moved by a type-erased move
+ * (a single memcpy if every stored type is trivially copyable), the old objects
+ * are destroyed only once all of them have been moved, so if a move throws
+ * the container is left as it was (as std::vector, a type whose move can throw
+ * is copied instead if it is copyable).
+ *
+ * the objects are destroyed as their own type, Base does not need a virtual
+ * destructor. Besides the table in insertion order, the offsets of the objects
+ * are also kept in one list per stored type, so for_each<D> walks only the
+ * objects whose type is exactly D, and the calls in its loop body can be
+ * devirtualized. The objects themselves stay in insertion order in the arena.
+ */
+template<typename Base>
+class poly_vector {
+  public:
+    static constexpr size_t ARENA_ALIGN = 64;
+
+  private:
+    struct entry {
+        size_t offset; // where the object starts in the arena
+        size_t base;   // where its Base subobject starts
+        const poly_detail::type_ops *ops;
+    };
+
+    // the offsets of the objects of one type, in insertion order
+    struct type_group {
+        const poly_detail::type_ops *ops;
+        vector<size_t> offsets;
+    };
+
+    std::byte          *_m_arena;
+    size_t              _m_used;
+    size_t              _m_cap;
+    vector<entry>       _m_table;
+    vector<type_group>  _m_groups;
+    size_t              _m_nontrivial; // objects which need a move call
+
+  public:
+    class const_iterator;
+    class iterator {
+      public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = Base;
+        using pointer = Base*;
+        using reference = Base&;
+        using iterator_category = std::random_access_iterator_tag;
+        friend class poly_vector;
+
+      private:
+        poly_vector *_pv;
+        size_t       _idx;
+        iterator(poly_vector *pv, size_t idx) : _pv(pv), _idx(idx) {}
+
+      public:
+        iterator() : _pv(nullptr), _idx(0) {}
+        iterator operator+(const difference_type &n) const {
+            return iterator(_pv, _idx + n);
+        }
+        friend iterator operator+(const difference_type &n, const iterator &it) {
+            return it + n;
+        }
+        iterator operator-(const difference_type &n) const {
+            return iterator(_pv, _idx - n);
+        }
+        // if these two iterators point to different containers, throw invaild_iterator.
+        difference_type operator-(const iterator &rhs) const {
+            if (_pv != rhs._pv) throw invalid_iterator();
+            return difference_type(_idx) - difference_type(rhs._idx);
+        }
+        iterator &operator+=(const difference_type &n) {
+            _idx += n;
+            return *this;
+        }
+        iterator &operator-=(const difference_type &n) {
+            _idx -= n;
+            return *this;
+        }
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++_idx;
+            return tmp;
+        }
+        iterator &operator++() {
+            ++_idx;
+            return *this;
+        }
+        iterator operator--(int) {
+            auto tmp = *this;
+            --_idx;
+            return tmp;
+        }
+        iterator &operator--() {
+            --_idx;
+            return *this;
+        }
+        Base &operator*() const {
+            return _pv->_get(_idx);
+        }
+        Base *operator->() const {
+            return &_pv->_get(_idx);
+        }
+        Base &operator[](const difference_type &n) const {
+            return _pv->_get(_idx + n);
+        }
+        bool operator==(const iterator &rhs) const {
+            return _pv == rhs._pv && _idx == rhs._idx;
+        }
+        bool operator!=(const iterator &rhs) const {
+            return !(*this == rhs);
+        }
+        auto operator<=>(const iterator &rhs) const {
+            return _idx <=> rhs._idx;
+        }
+    };
+    class const_iterator {
+      public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = Base;
+        using pointer = const Base*;
+        using reference = const Base&;
+        using iterator_category = std::random_access_iterator_tag;
+        friend class poly_vector;
+
+      private:
+        const poly_vector *_pv;
+        size_t             _idx;
+        const_iterator(const poly_vector *pv, size_t idx) : _pv(pv), _idx(idx) {}
+
+      public:
+        const_iterator() : _pv(nullptr), _idx(0) {}
+        const_iterator(const iterator &other) : _pv(other._pv), _idx(other._idx) {}
+        const_iterator operator+(const difference_type &n) const {
+            return const_iterator(_pv, _idx + n);
+        }
+        friend const_iterator operator+(const difference_type &n, const const_iterator &it) {
+            return it + n;
+        }
+        const_iterator operator-(const difference_type &n) const {
+            return const_iterator(_pv, _idx - n);
+        }
+        difference_type operator-(const const_iterator &rhs) const {
+            if (_pv != rhs._pv) throw invalid_iterator();
+            return difference_type(_idx) - difference_type(rhs._idx);
+        }
+        const_iterator &operator+=(const difference_type &n) {
+            _idx += n;
+            return *this;
+        }
+        const_iterator &operator-=(const difference_type &n) {
+            _idx -= n;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            ++_idx;
+            return tmp;
+        }
+        const_iterator &operator++() {
+            ++_idx;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto tmp = *this;
+            --_idx;
+            return tmp;
+        }
+        const_iterator &operator--() {
+            --_idx;
+            return *this;
+        }
+        const Base &operator*() const {
+            return _pv->_get(_idx);
+        }
+        const Base *operator->() const {
+            return &_pv->_get(_idx);
+        }
+        const Base &operator[](const difference_type &n) const {
+            return _pv->_get(_idx + n);
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return _pv == rhs._pv && _idx == rhs._idx;
+        }
+        bool operator!=(const const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+        auto operator<=>(const const_iterator &rhs) const {
+            return _idx <=> rhs._idx;
+        }
+    };
+    /**
+     * constructors
+     * the stored types are erased, so a poly_vector can be moved but not copied.
+     */
+    poly_vector() : _m_arena(nullptr), _m_used(0), _m_cap(0), _m_nontrivial(0) {}
+    poly_vector(const poly_vector &) = delete;
+    poly_vector(poly_vector &&other) noexcept
+        : _m_arena(other._m_arena), _m_used(other._m_used), _m_cap(other._m_cap),
+          _m_table(std::move(other._m_table)), _m_groups(std::move(other._m_groups)),
+          _m_nontrivial(other._m_nontrivial) {
+        other._m_arena = nullptr;
+        other._m_used = other._m_cap = other._m_nontrivial = 0;
+    }
+    /**
+     * destructor
+     */
+    ~poly_vector() {
+        clear();
+        _free_arena(_m_arena);
+    }
+    /**
+     * assignment operators
+     */
+    poly_vector &operator=(const poly_vector &) = delete;
+    poly_vector &operator=(poly_vector &&other) noexcept {
+        if (this == &other) return *this;
+        clear();
+        _free_arena(_m_arena);
+        _m_arena = other._m_arena;
+        _m_used = other._m_used;
+        _m_cap = other._m_cap;
+        _m_table = std::move(other._m_table);
+        _m_groups = std::move(other._m_groups);
+        _m_nontrivial = other._m_nontrivial;
+        other._m_arena = nullptr;
+        other._m_used = other._m_cap = other._m_nontrivial = 0;
+        return *this;
+    }
+    /**
+     * assigns specified element with bounds checking
+     * throw index_out_of_bound if pos is not in [0, size)
+     */
+    Base &at(const size_t &pos) {
+        if (pos >= _m_table.size()) throw index_out_of_bound();
+        return _get(pos);
+    }
+    const Base &at(const size_t &pos) const {
+        if (pos >= _m_table.size()) throw index_out_of_bound();
+        return _get(pos);
+    }
+    Base &operator[](const size_t &pos) {
+        return at(pos);
+    }
+    const Base &operator[](const size_t &pos) const {
+        return at(pos);
+    }
+    /**
+     * access the first / last element.
+     * throw container_is_empty if size == 0
+     */
+    Base &front() {
+        if (empty()) throw container_is_empty();
+        return _get(0);
+    }
+    const Base &front() const {
+        if (empty()) throw container_is_empty();
+        return _get(0);
+    }
+    Base &back() {
+        if (empty()) throw container_is_empty();
+        return _get(size() - 1);
+    }
+    const Base &back() const {
+        if (empty()) throw container_is_empty();
+        return _get(size() - 1);
+    }
+    /**
+     * checks whether the element at pos was constructed as exactly D.
+     * throw index_out_of_bound if pos is not in [0, size)
+     */
+    template<typename D>
+    bool holds(const size_t &pos) const {
+        if (pos >= _m_table.size()) throw index_out_of_bound();
+        return _m_table[pos].ops == &poly_detail::ops_for<D>;
+    }
+    /**
+     * iterators to the beginning and the end.
+     */
+    iterator begin() {
+        return iterator(this, 0);
+    }
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+    const_iterator cbegin() const {
+        return const_iterator(this, 0);
+    }
+    iterator end() {
+        return iterator(this, size());
+    }
+    const_iterator end() const {
+        return const_iterator(this, size());
+    }
+    const_iterator cend() const {
+        return const_iterator(this, size());
+    }
+    /**
+     * checks whether the container is empty
+     */
+    bool empty() const {
+        return _m_table.empty();
+    }
+    /**
+     * returns the number of elements
+     */
+    size_t size() const {
+        return _m_table.size();
+    }
+    /**
+     * the number of arena bytes in use / allocated.
+     */
+    size_t bytes() const {
+        return _m_used;
+    }
+    size_t capacity_bytes() const {
+        return _m_cap;
+    }
+    /**
+     * clears the contents, the arena is kept for reuse.
+     */
+    void clear() {
+        for (size_t i = 0; i < _m_table.size(); ++i) _destroy(_m_table[i]);
+        _m_table.clear();
+        for (size_t i = 0; i < _m_groups.size(); ++i) _m_groups[i].offsets.clear();
+        _m_used = 0;
+        _m_nontrivial = 0;
+    }
+    /**
+     * constructs a D from args at the end.
+     * returns a reference to it.
+     */
+    template<typename D, typename... Args>
+    D &emplace_back(Args &&...args) {
+        static_assert(std::derived_from<D, Base>, "poly_vector only stores types derived from Base");
+        static_assert(alignof(D) <= ARENA_ALIGN, "over-aligned types are not supported");
+        size_t offset = (_m_used + alignof(D) - 1) / alignof(D) * alignof(D);
+        D *obj;
+        if (offset + sizeof(D) > _m_cap) {
+            // args may refer to an element, so the new object is built before the old arena is freed
+            size_t cap = _grown_capacity(offset + sizeof(D));
+            std::byte *arena = _new_arena(cap);
+            try {
+                obj = std::construct_at(reinterpret_cast<D *>(arena + offset), std::forward<Args>(args)...);
+            } catch (...) {
+                _free_arena(arena);
+                throw;
+            }
+            try {
+                _relocate_into(arena);
+            } catch (...) {
+                std::destroy_at(obj);
+                _free_arena(arena);
+                throw;
+            }
+            _free_arena(_m_arena);
+            _m_arena = arena;
+            _m_cap = cap;
+        } else {
+            obj = std::construct_at(reinterpret_cast<D *>(_m_arena + offset), std::forward<Args>(args)...);
+        }
+        size_t base = reinterpret_cast<std::byte *>(static_cast<Base *>(obj)) - _m_arena;
+        const poly_detail::type_ops *ops = &poly_detail::ops_for<D>;
+        try {
+            _m_table.push_back({offset, base, ops});
+            try {
+                _group_for(ops).offsets.push_back(offset);
+            } catch (...) {
+                _m_table.pop_back();
+                throw;
+            }
+        } catch (...) {
+            std::destroy_at(obj);
+            throw;
+        }
+        _m_used = offset + sizeof(D);
+        if (ops->move) ++_m_nontrivial;
+        return *obj;
+    }
+    /**
+     * remove the last element from the end.
+     * throw container_is_empty if size() == 0
+     */
+    void pop_back() {
+        if (empty()) throw container_is_empty();
+        entry e = _m_table.back();
+        _destroy(e);
+        if (e.ops->move) --_m_nontrivial;
+        _m_table.pop_back();
+        _find_group(e.ops)->offsets.pop_back();
+        _m_used = e.offset;
+    }
+    /**
+     * call f(D &) for every element constructed as exactly D, in order.
+     * D is known statically, so virtual calls on it can be resolved at compile time
+     * (always if D is final).
+     */
+    template<typename D, typename F>
+    void for_each(F f) {
+        const type_group *g = _find_group(&poly_detail::ops_for<D>);
+        if (!g) return;
+        for (size_t i = 0; i < g->offsets.size(); ++i) f(*std::launder(reinterpret_cast<D *>(_m_arena + g->offsets[i])));
+    }
+    template<typename D, typename F>
+    void for_each(F f) const {
+        const type_group *g = _find_group(&poly_detail::ops_for<D>);
+        if (!g) return;
+        for (size_t i = 0; i < g->offsets.size(); ++i) {
+            f(*std::launder(reinterpret_cast<const D *>(_m_arena + g->offsets[i])));
+        }
+    }
+    /**
+     * returns the number of elements constructed as exactly D.
+     */
+    template<typename D>
+    size_t count() const {
+        const type_group *g = _find_group(&poly_detail::ops_for<D>);
+        return g ? g->offsets.size() : 0;
+    }
+
+  private:
+    Base &_get(size_t i) {
+        return *std::launder(reinterpret_cast<Base *>(_m_arena + _m_table[i].base));
+    }
+    const Base &_get(size_t i) const {
+        return *std::launder(reinterpret_cast<const Base *>(_m_arena + _m_table[i].base));
+    }
+    void _destroy(const entry &e) {
+        if (e.ops->destroy) e.ops->destroy(_m_arena + e.offset);
+    }
+    static void _free_arena(std::byte *arena) {
+        if (arena) ::operator delete(arena, std::align_val_t(ARENA_ALIGN));
+    }
+    // the stored types are few, a linear search is enough
+    const type_group *_find_group(const poly_detail::type_ops *ops) const {
+        for (size_t i = 0; i < _m_groups.size(); ++i) {
+            if (_m_groups[i].ops == ops) return &_m_groups[i];
+        }
+        return nullptr;
+    }
+    type_group *_find_group(const poly_detail::type_ops *ops) {
+        return const_cast<type_group *>(std::as_const(*this)._find_group(ops));
+    }
+    type_group &_group_for(const poly_detail::type_ops *ops) {
+        if (type_group *g = _find_group(ops)) return *g;
+        _m_groups.push_back({ops, vector<size_t>()});
+        return _m_groups[_m_groups.size() - 1];
+    }
+    size_t _grown_capacity(size_t need) const {
+        return max(max(need, _m_cap * 2), size_t(256));
+    }
+    static std::byte *_new_arena(size_t cap) {
+        return static_cast<std::byte *>(::operator new(cap, std::align_val_t(ARENA_ALIGN)));
+    }
+    // move every object into arena at the same offsets, the old arena is left to the caller.
+    // if a move throws, the objects already moved into arena are destroyed and the old ones are kept
+    void _relocate_into(std::byte *arena) {
+        if (_m_nontrivial == 0) {
+            if (_m_used) std::memcpy(arena, _m_arena, _m_used);
+            return;
+        }
+        size_t i = 0;
+        try {
+            for (; i < _m_table.size(); ++i) {
+                const entry &e = _m_table[i];
+                if (e.ops->move) e.ops->move(arena + e.offset, _m_arena + e.offset);
+                else std::memcpy(arena + e.offset, _m_arena + e.offset, _size_until_next(i));
+            }
+        } catch (...) {
+            while (i-- > 0) {
+                if (_m_table[i].ops->destroy) _m_table[i].ops->destroy(arena + _m_table[i].offset);
+            }
+            throw;
+        }
+        for (i = 0; i < _m_table.size(); ++i) _destroy(_m_table[i]);
+    }
+    // bytes from object i up to the next object (or the end), covers its size
+    size_t _size_until_next(size_t i) const {
+        return (i + 1 < _m_table.size() ? _m_table[i + 1].offset : _m_used) - _m_table[i].offset;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,251 @@
+#ifndef SJTU_RADIX_SORT_HPP
+#define SJTU_RADIX_SORT_HPP
+
+#include "vector.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+/**
+ * LSD radix sort for sjtu::vector.
+ *
+ *   radix_sort(vec)          sorts a vector of integers or floating points.
+ *   sort_by_key(vec, keyfn)  sorts records by an integer / floating key,
+ *                            keyfn is called exactly once per element.
+ *
+ * Both sorts are stable. Keys are mapped to unsigned integers which keep
+ * their order, then sorted 8 bits per pass through a scratch buffer.
+ * All the histograms are counted in a single read pass (in parallel on
+ * large inputs), and a pass is skipped when its digit is the same for
+ * every element, e.g. the high bytes of small integers.
+ */
+namespace radix_detail {
+
+constexpr size_t RADIX_BITS = 8;
+constexpr size_t RADIX_SIZE = size_t(1) << RADIX_BITS;
+// below this size the histograms are counted by the calling thread only
+constexpr size_t PARALLEL_THRESHOLD = size_t(1) << 20;
+// every worker thread counts at least this many keys
+constexpr size_t PARALLEL_GRAIN = size_t(1) << 18;
+
+// integers but bool, and the 32 / 64 bit IEEE floating points (not e.g. an 80 bit long double)
+template<typename K>
+concept radix_key_type = (std::is_integral_v<K> && !std::is_same_v<K, bool>) ||
+                         (std::is_floating_point_v<K> && std::numeric_limits<K>::is_iec559 &&
+                          (sizeof(K) == 4 || sizeof(K) == 8));
+
+template<typename K>
+struct unsigned_key {
+    using type = std::make_unsigned_t<K>;
+};
+template<typename K>
+    requires std::is_floating_point_v<K>
+struct unsigned_key<K> {
+    using type = std::conditional_t<sizeof(K) == 4, uint32_t, uint64_t>;
+};
+template<typename K>
+using unsigned_key_t = typename unsigned_key<K>::type;
+
+/**
+ * map a key to an unsigned integer with the same order.
+ * signed integers: flip the sign bit.
+ * floating points: flip all bits of negatives, the sign bit of positives.
+ */
+template<radix_key_type K>
+unsigned_key_t<K> encode(K k) {
+    using U = unsigned_key_t<K>;
+    constexpr U sign = U(1) << (sizeof(U) * 8 - 1);
+    if constexpr (std::is_floating_point_v<K>) {
+        U u = std::bit_cast<U>(k);
+        return (u & sign) ? U(~u) : U(u | sign);
+    } else if constexpr (std::is_signed_v<K>) {
+        return U(k) ^ sign;
+    } else {
+        return k;
+    }
+}
+
+template<radix_key_type K>
+K decode(unsigned_key_t<K> u) {
+    using U = unsigned_key_t<K>;
+    constexpr U sign = U(1) << (sizeof(U) * 8 - 1);
+    if constexpr (std::is_floating_point_v<K>) {
+        return std::bit_cast<K>((u & sign) ? U(u ^ sign) : U(~u));
+    } else if constexpr (std::is_signed_v<K>) {
+        return K(u ^ sign);
+    } else {
+        return u;
+    }
+}
+
+// n uninitialized elements of scratch space, returned to the allocator on scope exit
+template<typename T>
+class scratch {
+  private:
+    std::allocator<T> _alloc;
+    T *_m_data;
+    size_t _m_size;
+
+  public:
+    explicit scratch(size_t n) : _m_data(_alloc.allocate(n)), _m_size(n) {}
+    scratch(const scratch &) = delete;
+    scratch &operator=(const scratch &) = delete;
+    ~scratch() {
+        _alloc.deallocate(_m_data, _m_size);
+    }
+    T *data() const {
+        return _m_data;
+    }
+};
+
+template<typename U>
+struct histogram {
+    static constexpr size_t DIGITS = sizeof(U);
+    size_t count[DIGITS][RADIX_SIZE];
+};
+
+template<typename U>
+void count_digits(const U *keys, size_t n, histogram<U> &h) {
+    std::fill(&h.count[0][0], &h.count[0][0] + histogram<U>::DIGITS * RADIX_SIZE, size_t(0));
+    for (size_t i = 0; i < n; ++i) {
+        U k = keys[i];
+        for (size_t d = 0; d < histogram<U>::DIGITS; ++d) {
+            ++h.count[d][(k >> (d * RADIX_BITS)) & (RADIX_SIZE - 1)];
+        }
+    }
+}
+
+// count the histograms of all digits, split among threads if n is large.
+template<typename U>
+void build_histogram(const U *keys, size_t n, histogram<U> &h) {
+    size_t workers = 1;
+    if (n >= PARALLEL_THRESHOLD) {
+        workers = std::min<size_t>(std::thread::hardware_concurrency(), n / PARALLEL_GRAIN);
+    }
+    if (workers <= 1) {
+        count_digits(keys, n, h);
+        return;
+    }
+    std::unique_ptr<histogram<U>[]> partial(new histogram<U>[workers]);
+    // a jthread joins on destruction, so the started workers are joined if starting another one throws
+    std::unique_ptr<std::jthread[]> threads(new std::jthread[workers - 1]);
+    size_t chunk = (n + workers - 1) / workers;
+    for (size_t w = 1; w < workers; ++w) {
+        size_t lo = std::min(n, w * chunk), hi = std::min(n, lo + chunk);
+        threads[w - 1] = std::jthread(count_digits<U>, keys + lo, hi - lo, std::ref(partial[w]));
+    }
+    count_digits(keys, std::min(n, chunk), partial[0]);
+    for (size_t w = 1; w < workers; ++w) threads[w - 1].join();
+    h = partial[0];
+    for (size_t w = 1; w < workers; ++w) {
+        for (size_t d = 0; d < histogram<U>::DIGITS; ++d) {
+            for (size_t b = 0; b < RADIX_SIZE; ++b) h.count[d][b] += partial[w].count[d][b];
+        }
+    }
+}
+
+// turn the counts of digit d into starting offsets,
+// return false if every key has the same digit so the pass can be skipped.
+template<typename U>
+bool prefix_offsets(histogram<U> &h, size_t d, size_t n) {
+    size_t sum = 0;
+    for (size_t b = 0; b < RADIX_SIZE; ++b) {
+        if (h.count[d][b] == n) return false;
+        size_t c = h.count[d][b];
+        h.count[d][b] = sum;
+        sum += c;
+    }
+    return true;
+}
+
+/**
+ * sort keys[0, n) together with vals[0, n) (if vals is not null).
+ * key_buf / val_buf are scratch buffers of n elements, val_buf is uninitialized.
+ * vals are relocated between the two buffers, which is why T must be nothrow
+ * move constructible: a throwing move would leave destroyed elements behind.
+ */
+template<typename U, typename T>
+    requires std::is_nothrow_move_constructible_v<T>
+void lsd_sort(U *keys, U *key_buf, T *vals, T *val_buf, size_t n) {
+    histogram<U> h;
+    build_histogram(keys, n, h);
+    U *src_key = keys, *dst_key = key_buf;
+    T *src_val = vals, *dst_val = val_buf;
+    for (size_t d = 0; d < histogram<U>::DIGITS; ++d) {
+        if (!prefix_offsets(h, d, n)) continue;
+        size_t *offset = h.count[d];
+        size_t shift = d * RADIX_BITS;
+        for (size_t i = 0; i < n; ++i) {
+            size_t pos = offset[(src_key[i] >> shift) & (RADIX_SIZE - 1)]++;
+            dst_key[pos] = src_key[i];
+            if (vals) {
+                std::construct_at(dst_val + pos, std::move(src_val[i]));
+                std::destroy_at(src_val + i);
+            }
+        }
+        std::swap(src_key, dst_key);
+        std::swap(src_val, dst_val);
+    }
+    if (src_key == keys) return;
+    std::copy(src_key, src_key + n, keys);
+    if (vals) {
+        for (size_t i = 0; i < n; ++i) {
+            std::construct_at(vals + i, std::move(src_val[i]));
+            std::destroy_at(src_val + i);
+        }
+    }
+}
+
+} // namespace radix_detail
+
+/**
+ * sort a vector of integers / floating points in ascending order.
+ * for floating points, -0.0 is placed before +0.0.
+ */
+template<radix_detail::radix_key_type K>
+void radix_sort(vector<K> &vec) {
+    using U = radix_detail::unsigned_key_t<K>;
+    size_t n = vec.size();
+    if (n < 2) return;
+    radix_detail::scratch<U> buf(2 * n);
+    U *keys = buf.data();
+    K *data = vec.data();
+    for (size_t i = 0; i < n; ++i) keys[i] = radix_detail::encode(data[i]);
+    radix_detail::lsd_sort<U, K>(keys, keys + n, nullptr, nullptr, n);
+    for (size_t i = 0; i < n; ++i) data[i] = radix_detail::decode<K>(keys[i]);
+}
+
+/**
+ * stable sort of records by keyfn(record) in ascending order,
+ *   keyfn is called through std::invoke (so a pointer to a data member or a
+ *   const member function works too), it must return an integer or a float /
+ *   double, and T must be nothrow move constructible.
+ * if keyfn throws, vec is left unchanged.
+ */
+template<typename T, typename KeyFn>
+    requires radix_detail::radix_key_type<std::decay_t<std::invoke_result_t<KeyFn &, const T &>>> &&
+             std::is_nothrow_move_constructible_v<T>
+void sort_by_key(vector<T> &vec, KeyFn keyfn) {
+    using K = std::decay_t<std::invoke_result_t<KeyFn &, const T &>>;
+    using U = radix_detail::unsigned_key_t<K>;
+    size_t n = vec.size();
+    if (n < 2) return;
+    radix_detail::scratch<U> keys(2 * n);
+    radix_detail::scratch<T> val_buf(n);
+    T *data = vec.data();
+    for (size_t i = 0; i < n; ++i) keys.data()[i] = radix_detail::encode(K(std::invoke(keyfn, std::as_const(data[i]))));
+    radix_detail::lsd_sort(keys.data(), keys.data() + n, data, val_buf.data(), n);
+}
+
+}
+
+#endif
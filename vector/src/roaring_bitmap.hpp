@@ -0,0 +1,556 @@
+#ifndef SJTU_ROARING_BITMAP_HPP
+#define SJTU_ROARING_BITMAP_HPP
+
+#include "vector.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace sjtu {
+/**
+ * a compressed set of 32-bit integers (roaring bitmap).
+ *
+ * the high 16 bits of a value select a container, kept in a vector sorted
+ * by the high key, and the container stores the low 16 bits as one of
+ *   - array:  a sorted vector of at most 4096 values,
+ *   - bitmap: 65536 bits, used once an array would be larger,
+ *   - run:    sorted [start, last] intervals, chosen by run_optimize().
+ *
+ * set algebra works container by container, with fast paths for
+ * array-array (merge), array-bitmap (filter) and bitmap-bitmap (word ops).
+ * serialize() writes a portable little-endian byte format.
+ */
+class roaring_bitmap {
+  public:
+    enum container_kind : uint8_t { ARRAY = 0, BITMAP = 1, RUN = 2 };
+
+  private:
+    static constexpr uint32_t ARRAY_LIMIT = 4096;
+    static constexpr size_t   WORDS = 1024;
+    static constexpr uint32_t COOKIE = 0x42524a53; // "SJRB"
+
+    enum op_kind { AND, OR, ANDNOT, XOR };
+
+    struct run {
+        uint16_t start;
+        uint16_t last;
+    };
+
+    struct container {
+        container_kind   kind;
+        uint32_t         card;
+        vector<uint16_t> array;  // ARRAY: sorted values
+        vector<uint64_t> bitmap; // BITMAP: WORDS words
+        vector<run>      runs;   // RUN: sorted, disjoint, non-adjacent intervals
+
+        container() : kind(ARRAY), card(0) {}
+
+        bool contains(uint16_t x) const {
+            switch (kind) {
+            case ARRAY:
+                return std::binary_search(array.data(), array.data() + array.size(), x);
+            case BITMAP:
+                return bitmap.data()[x >> 6] >> (x & 63) & 1;
+            default: {
+                // the last run starting at or before x
+                const run *r = std::upper_bound(runs.data(), runs.data() + runs.size(), x,
+                                                [](uint16_t v, const run &rr) { return v < rr.start; });
+                return r != runs.data() && x <= (r - 1)->last;
+            }
+            }
+        }
+
+        // fill out[0, WORDS) with the bitmap of this container
+        void to_words(uint64_t *out) const {
+            if (kind == BITMAP) {
+                std::copy(bitmap.data(), bitmap.data() + WORDS, out);
+                return;
+            }
+            std::fill(out, out + WORDS, uint64_t(0));
+            if (kind == ARRAY) {
+                for (size_t i = 0; i < array.size(); ++i) out[array[i] >> 6] |= uint64_t(1) << (array[i] & 63);
+            } else {
+                for (size_t i = 0; i < runs.size(); ++i) set_range(out, runs[i].start, runs[i].last);
+            }
+        }
+
+        static void set_range(uint64_t *words, uint32_t lo, uint32_t hi) {
+            for (uint32_t w = lo >> 6; w <= (hi >> 6); ++w) {
+                uint32_t from = w == (lo >> 6) ? lo & 63 : 0;
+                uint32_t to = w == (hi >> 6) ? hi & 63 : 63;
+                uint64_t mask = (to == 63 ? ~uint64_t(0) : (uint64_t(1) << (to + 1)) - 1) & (~uint64_t(0) << from);
+                words[w] |= mask;
+            }
+        }
+
+        // build from a bitmap with the given cardinality, as an array if it is small enough
+        static container from_words(const uint64_t *words, uint32_t card) {
+            container c;
+            c.card = card;
+            if (card <= ARRAY_LIMIT) {
+                c.kind = ARRAY;
+                for (size_t w = 0; w < WORDS; ++w) {
+                    for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+                        c.array.push_back(uint16_t(w * 64 + std::countr_zero(bits)));
+                    }
+                }
+            } else {
+                c.kind = BITMAP;
+                for (size_t w = 0; w < WORDS; ++w) c.bitmap.push_back(words[w]);
+            }
+            return c;
+        }
+
+        // turn a run container into an array / bitmap so that it can be modified
+        void expand() {
+            if (kind != RUN) return;
+            uint64_t words[WORDS];
+            to_words(words);
+            *this = from_words(words, card);
+        }
+
+        bool add(uint16_t x) {
+            expand();
+            if (kind == BITMAP) {
+                uint64_t &w = bitmap[x >> 6];
+                uint64_t bit = uint64_t(1) << (x & 63);
+                if (w & bit) return false;
+                w |= bit;
+                ++card;
+                return true;
+            }
+            const uint16_t *p = std::lower_bound(array.data(), array.data() + array.size(), x);
+            size_t pos = p - array.data();
+            if (pos < array.size() && array[pos] == x) return false;
+            if (card == ARRAY_LIMIT) {
+                uint64_t words[WORDS];
+                to_words(words);
+                words[x >> 6] |= uint64_t(1) << (x & 63);
+                *this = from_words(words, card + 1);
+                return true;
+            }
+            array.insert(pos, x);
+            ++card;
+            return true;
+        }
+
+        bool remove(uint16_t x) {
+            if (!contains(x)) return false;
+            expand();
+            if (kind == BITMAP) {
+                bitmap[x >> 6] &= ~(uint64_t(1) << (x & 63));
+                if (--card <= ARRAY_LIMIT) *this = from_words(bitmap.data(), card);
+                return true;
+            }
+            const uint16_t *p = std::lower_bound(array.data(), array.data() + array.size(), x);
+            array.erase(p - array.data());
+            --card;
+            return true;
+        }
+
+        template<typename F>
+        void for_each(uint32_t high, F &f) const {
+            switch (kind) {
+            case ARRAY:
+                for (size_t i = 0; i < array.size(); ++i) f(high | array[i]);
+                break;
+            case BITMAP:
+                for (size_t w = 0; w < WORDS; ++w) {
+                    for (uint64_t bits = bitmap[w]; bits; bits &= bits - 1) {
+                        f(high | uint32_t(w * 64 + std::countr_zero(bits)));
+                    }
+                }
+                break;
+            default:
+                for (size_t i = 0; i < runs.size(); ++i) {
+                    for (uint32_t v = runs[i].start; v <= runs[i].last; ++v) f(high | v);
+                }
+            }
+        }
+
+        // the number of bytes of the payload in each representation
+        size_t bytes() const {
+            switch (kind) {
+            case ARRAY: return array.size() * sizeof(uint16_t);
+            case BITMAP: return WORDS * sizeof(uint64_t);
+            default: return runs.size() * sizeof(run);
+            }
+        }
+
+        // convert to runs if that is the smallest representation, or back if not
+        void optimize() {
+            expand();
+            vector<run> r;
+            auto extend = [&](uint32_t v) {
+                if (!r.empty() && r[r.size() - 1].last + 1u == v) ++r[r.size() - 1].last;
+                else r.push_back({uint16_t(v), uint16_t(v)});
+            };
+            for_each(0, extend);
+            size_t run_bytes = r.size() * sizeof(run);
+            if (run_bytes < bytes()) {
+                kind = RUN;
+                runs = std::move(r);
+                array.clear();
+                bitmap.clear();
+            }
+        }
+
+        bool operator==(const container &rhs) const {
+            if (card != rhs.card) return false;
+            uint64_t a[WORDS], b[WORDS];
+            to_words(a);
+            rhs.to_words(b);
+            return std::equal(a, a + WORDS, b);
+        }
+    };
+
+    vector<uint16_t>  _m_keys;
+    vector<container> _m_conts;
+
+  public:
+    /**
+     * constructors
+     */
+    roaring_bitmap() = default;
+    roaring_bitmap(const roaring_bitmap &other) = default;
+    roaring_bitmap(roaring_bitmap &&other) = default;
+    roaring_bitmap &operator=(const roaring_bitmap &other) = default;
+    roaring_bitmap &operator=(roaring_bitmap &&other) = default;
+    /**
+     * build from a vector of values, in any order.
+     */
+    explicit roaring_bitmap(const vector<uint32_t> &values) {
+        for (size_t i = 0; i < values.size(); ++i) add(values[i]);
+    }
+    /**
+     * adds x, returns false if it was already in the set.
+     */
+    bool add(uint32_t x) {
+        size_t i = _lower_bound(x >> 16);
+        if (i == _m_keys.size() || _m_keys[i] != (x >> 16)) {
+            _m_keys.insert(i, uint16_t(x >> 16));
+            _m_conts.insert(i, container());
+        }
+        return _m_conts[i].add(uint16_t(x));
+    }
+    /**
+     * removes x, returns false if it was not in the set.
+     */
+    bool remove(uint32_t x) {
+        size_t i = _lower_bound(x >> 16);
+        if (i == _m_keys.size() || _m_keys[i] != (x >> 16)) return false;
+        if (!_m_conts[i].remove(uint16_t(x))) return false;
+        if (_m_conts[i].card == 0) {
+            _m_keys.erase(i);
+            _m_conts.erase(i);
+        }
+        return true;
+    }
+    /**
+     * checks whether x is in the set
+     */
+    bool contains(uint32_t x) const {
+        size_t i = _lower_bound(x >> 16);
+        return i < _m_keys.size() && _m_keys[i] == (x >> 16) && _m_conts[i].contains(uint16_t(x));
+    }
+    /**
+     * returns the number of values
+     */
+    size_t cardinality() const {
+        size_t n = 0;
+        for (size_t i = 0; i < _m_conts.size(); ++i) n += _m_conts[i].card;
+        return n;
+    }
+    size_t size() const {
+        return cardinality();
+    }
+    /**
+     * checks whether the set is empty
+     */
+    bool empty() const {
+        return _m_keys.empty();
+    }
+    /**
+     * clears the contents
+     */
+    void clear() {
+        _m_keys.clear();
+        _m_conts.clear();
+    }
+    /**
+     * call f(value) for every value in ascending order.
+     */
+    template<typename F>
+    void for_each(F f) const {
+        for (size_t i = 0; i < _m_conts.size(); ++i) _m_conts[i].for_each(uint32_t(_m_keys[i]) << 16, f);
+    }
+    /**
+     * the values in ascending order.
+     */
+    vector<uint32_t> to_vector() const {
+        vector<uint32_t> out;
+        for_each([&](uint32_t x) { out.push_back(x); });
+        return out;
+    }
+    /**
+     * convert every container to runs where that takes less memory.
+     */
+    void run_optimize() {
+        for (size_t i = 0; i < _m_conts.size(); ++i) _m_conts[i].optimize();
+    }
+    /**
+     * the number of bytes taken by the containers' payloads and keys.
+     */
+    size_t memory_usage() const {
+        size_t n = sizeof(*this) + _m_keys.capacity() * sizeof(uint16_t) + _m_conts.capacity() * sizeof(container);
+        for (size_t i = 0; i < _m_conts.size(); ++i) n += _m_conts[i].bytes();
+        return n;
+    }
+
+    bool operator==(const roaring_bitmap &rhs) const {
+        if (_m_keys.size() != rhs._m_keys.size()) return false;
+        for (size_t i = 0; i < _m_keys.size(); ++i) {
+            if (_m_keys[i] != rhs._m_keys[i] || !(_m_conts[i] == rhs._m_conts[i])) return false;
+        }
+        return true;
+    }
+    bool operator!=(const roaring_bitmap &rhs) const {
+        return !(*this == rhs);
+    }
+    /**
+     * set algebra: intersection, union, difference and symmetric difference.
+     */
+    friend roaring_bitmap operator&(const roaring_bitmap &a, const roaring_bitmap &b) {
+        return _combine(a, b, AND);
+    }
+    friend roaring_bitmap operator|(const roaring_bitmap &a, const roaring_bitmap &b) {
+        return _combine(a, b, OR);
+    }
+    friend roaring_bitmap operator-(const roaring_bitmap &a, const roaring_bitmap &b) {
+        return _combine(a, b, ANDNOT);
+    }
+    friend roaring_bitmap operator^(const roaring_bitmap &a, const roaring_bitmap &b) {
+        return _combine(a, b, XOR);
+    }
+    roaring_bitmap &operator&=(const roaring_bitmap &rhs) {
+        return *this = *this & rhs;
+    }
+    roaring_bitmap &operator|=(const roaring_bitmap &rhs) {
+        return *this = *this | rhs;
+    }
+    roaring_bitmap &operator-=(const roaring_bitmap &rhs) {
+        return *this = *this - rhs;
+    }
+    roaring_bitmap &operator^=(const roaring_bitmap &rhs) {
+        return *this = *this ^ rhs;
+    }
+    /**
+     * write the set in a portable format:
+     *   u32 cookie, u32 container count, then for every container
+     *   u16 key, u8 kind, u32 count, and the payload
+     *   (count u16 values / 1024 u64 words / count u16 start, u16 last pairs),
+     * all integers little-endian.
+     */
+    vector<uint8_t> serialize() const {
+        vector<uint8_t> out;
+        _put(out, COOKIE, 4);
+        _put(out, _m_keys.size(), 4);
+        for (size_t i = 0; i < _m_conts.size(); ++i) {
+            const container &c = _m_conts[i];
+            _put(out, _m_keys[i], 2);
+            _put(out, c.kind, 1);
+            switch (c.kind) {
+            case ARRAY:
+                _put(out, c.array.size(), 4);
+                for (size_t j = 0; j < c.array.size(); ++j) _put(out, c.array[j], 2);
+                break;
+            case BITMAP:
+                _put(out, c.card, 4);
+                for (size_t j = 0; j < WORDS; ++j) _put(out, c.bitmap[j], 8);
+                break;
+            default:
+                _put(out, c.runs.size(), 4);
+                for (size_t j = 0; j < c.runs.size(); ++j) {
+                    _put(out, c.runs[j].start, 2);
+                    _put(out, c.runs[j].last, 2);
+                }
+            }
+        }
+        return out;
+    }
+    /**
+     * read a set written by serialize(),
+     * throw runtime_error if the bytes are not a valid set.
+     */
+    static roaring_bitmap deserialize(const uint8_t *bytes, size_t len) {
+        size_t pos = 0;
+        if (_get(bytes, len, pos, 4) != COOKIE) throw runtime_error();
+        size_t n = _get(bytes, len, pos, 4);
+        roaring_bitmap r;
+        for (size_t i = 0; i < n; ++i) {
+            uint16_t key = _get(bytes, len, pos, 2);
+            if (i > 0 && key <= r._m_keys[i - 1]) throw runtime_error();
+            container c;
+            c.kind = container_kind(_get(bytes, len, pos, 1));
+            uint32_t count = _get(bytes, len, pos, 4);
+            switch (c.kind) {
+            case ARRAY:
+                if (count == 0 || count > ARRAY_LIMIT) throw runtime_error();
+                for (uint32_t j = 0; j < count; ++j) {
+                    uint16_t v = _get(bytes, len, pos, 2);
+                    if (j > 0 && v <= c.array[j - 1]) throw runtime_error();
+                    c.array.push_back(v);
+                }
+                c.card = count;
+                break;
+            case BITMAP: {
+                uint32_t card = 0;
+                for (size_t j = 0; j < WORDS; ++j) {
+                    c.bitmap.push_back(_get(bytes, len, pos, 8));
+                    card += std::popcount(c.bitmap[j]);
+                }
+                if (card != count || card <= ARRAY_LIMIT) throw runtime_error();
+                c.card = card;
+                break;
+            }
+            case RUN:
+                if (count == 0) throw runtime_error();
+                for (uint32_t j = 0; j < count; ++j) {
+                    run rr;
+                    rr.start = _get(bytes, len, pos, 2);
+                    rr.last = _get(bytes, len, pos, 2);
+                    if (rr.last < rr.start || (j > 0 && rr.start <= c.runs[j - 1].last + 1u)) throw runtime_error();
+                    c.runs.push_back(rr);
+                    c.card += rr.last - rr.start + 1u;
+                }
+                break;
+            default:
+                throw runtime_error();
+            }
+            r._m_keys.push_back(key);
+            r._m_conts.push_back(std::move(c));
+        }
+        if (pos != len) throw runtime_error();
+        return r;
+    }
+    static roaring_bitmap deserialize(const vector<uint8_t> &bytes) {
+        return deserialize(bytes.data(), bytes.size());
+    }
+
+  private:
+    size_t _lower_bound(uint32_t high) const {
+        return std::lower_bound(_m_keys.data(), _m_keys.data() + _m_keys.size(), high) - _m_keys.data();
+    }
+
+    static void _put(vector<uint8_t> &out, uint64_t v, size_t bytes) {
+        for (size_t i = 0; i < bytes; ++i) out.push_back(uint8_t(v >> (8 * i)));
+    }
+
+    static uint64_t _get(const uint8_t *in, size_t len, size_t &pos, size_t bytes) {
+        if (pos > len || len - pos < bytes) throw runtime_error();
+        uint64_t v = 0;
+        for (size_t i = 0; i < bytes; ++i) v |= uint64_t(in[pos + i]) << (8 * i);
+        pos += bytes;
+        return v;
+    }
+
+    static bool _apply(op_kind op, bool x, bool y) {
+        switch (op) {
+        case AND: return x && y;
+        case OR: return x || y;
+        case ANDNOT: return x && !y;
+        default: return x != y;
+        }
+    }
+
+    // combine two containers with the same high key, the result may be empty
+    static container _combine(const container &a, const container &b, op_kind op) {
+        if (a.kind == ARRAY && b.kind == ARRAY) {
+            // merge two sorted arrays
+            container c;
+            size_t i = 0, j = 0;
+            while (i < a.array.size() || j < b.array.size()) {
+                bool in_a = i < a.array.size(), in_b = j < b.array.size();
+                uint16_t v;
+                if (in_a && in_b) {
+                    if (a.array[i] < b.array[j]) v = a.array[i++], in_b = false;
+                    else if (b.array[j] < a.array[i]) v = b.array[j++], in_a = false;
+                    else v = a.array[i++], ++j;
+                } else if (in_a) {
+                    if (op == AND) break;
+                    v = a.array[i++];
+                } else {
+                    if (op == AND || op == ANDNOT) break;
+                    v = b.array[j++];
+                }
+                if (_apply(op, in_a, in_b)) c.array.push_back(v);
+            }
+            c.card = c.array.size();
+            if (c.card > ARRAY_LIMIT) {
+                uint64_t words[WORDS];
+                c.to_words(words);
+                c = container::from_words(words, c.card);
+            }
+            return c;
+        }
+        if (a.kind == ARRAY && (op == AND || op == ANDNOT)) {
+            // filter the array by the other container
+            container c;
+            for (size_t i = 0; i < a.array.size(); ++i) {
+                if (b.contains(a.array[i]) == (op == AND)) c.array.push_back(a.array[i]);
+            }
+            c.card = c.array.size();
+            return c;
+        }
+        uint64_t x[WORDS], y[WORDS];
+        a.to_words(x);
+        b.to_words(y);
+        uint32_t card = 0;
+        for (size_t w = 0; w < WORDS; ++w) {
+            switch (op) {
+            case AND: x[w] &= y[w]; break;
+            case OR: x[w] |= y[w]; break;
+            case ANDNOT: x[w] &= ~y[w]; break;
+            default: x[w] ^= y[w];
+            }
+            card += std::popcount(x[w]);
+        }
+        return container::from_words(x, card);
+    }
+
+    static roaring_bitmap _combine(const roaring_bitmap &a, const roaring_bitmap &b, op_kind op) {
+        roaring_bitmap r;
+        size_t i = 0, j = 0;
+        bool keep_a = op != AND, keep_b = op == OR || op == XOR;
+        while (i < a._m_keys.size() || j < b._m_keys.size()) {
+            if (j == b._m_keys.size() || (i < a._m_keys.size() && a._m_keys[i] < b._m_keys[j])) {
+                if (keep_a) {
+                    r._m_keys.push_back(a._m_keys[i]);
+                    r._m_conts.push_back(a._m_conts[i]);
+                }
+                ++i;
+            } else if (i == a._m_keys.size() || b._m_keys[j] < a._m_keys[i]) {
+                if (keep_b) {
+                    r._m_keys.push_back(b._m_keys[j]);
+                    r._m_conts.push_back(b._m_conts[j]);
+                }
+                ++j;
+            } else {
+                container c = _combine(a._m_conts[i], b._m_conts[j], op);
+                if (c.card > 0) {
+                    r._m_keys.push_back(a._m_keys[i]);
+                    r._m_conts.push_back(std::move(c));
+                }
+                ++i, ++j;
+            }
+        }
+        return r;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,495 @@
+#ifndef SJTU_SHARED_MEMORY_HPP
+#define SJTU_SHARED_MEMORY_HPP
+
+#include "exceptions.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sjtu {
+
+/**
+ * a pointer which stores the distance from itself to the target,
+ * so it stays valid when the memory holding both of them is mapped
+ * at different addresses in different processes.
+ *
+ * copying recomputes the distance, and it converts implicitly to T*,
+ * so it can replace a raw pointer in the containers.
+ */
+template<typename T>
+class offset_ptr {
+  private:
+    // 1 can never be the distance to a T stored next to us, it means null
+    static constexpr std::ptrdiff_t NULL_OFFSET = 1;
+    std::ptrdiff_t m_off;
+
+    // the arithmetic is done on integers, the target is not part of this object
+    // and the compiler must not assume so
+    void set(const volatile void *p) {
+        m_off = p ? std::ptrdiff_t(reinterpret_cast<std::uintptr_t>(p) - reinterpret_cast<std::uintptr_t>(this))
+                  : NULL_OFFSET;
+    }
+
+  public:
+    using element_type = T;
+    using difference_type = std::ptrdiff_t;
+
+    offset_ptr() : m_off(NULL_OFFSET) {}
+    offset_ptr(std::nullptr_t) : m_off(NULL_OFFSET) {}
+    offset_ptr(T *p) { set(p); }
+    offset_ptr(const offset_ptr &other) { set(other.get()); }
+    template<typename U>
+        requires std::is_convertible_v<U *, T *>
+    offset_ptr(const offset_ptr<U> &other) { set(static_cast<T *>(other.get())); }
+    // static_cast between related pointers, used by std::allocator_traits
+    template<typename U>
+        requires (!std::is_convertible_v<U *, T *>)
+    explicit offset_ptr(const offset_ptr<U> &other) { set(static_cast<T *>(other.get())); }
+
+    offset_ptr &operator=(const offset_ptr &other) {
+        set(other.get());
+        return *this;
+    }
+    offset_ptr &operator=(T *p) {
+        set(p);
+        return *this;
+    }
+
+    T *get() const {
+        if (m_off == NULL_OFFSET) return nullptr;
+        return reinterpret_cast<T *>(reinterpret_cast<std::uintptr_t>(this) + m_off);
+    }
+    operator T *() const {
+        return get();
+    }
+    T *operator->() const {
+        return get();
+    }
+    template<typename U = T>
+        requires (!std::is_void_v<U>)
+    U &operator*() const {
+        return *get();
+    }
+
+    template<typename U = T>
+        requires (!std::is_void_v<U>)
+    static offset_ptr pointer_to(U &r) {
+        return offset_ptr(std::addressof(r));
+    }
+};
+
+/**
+ * the header at the beginning of a shared memory segment.
+ *
+ * it owns an allocator working on offsets only. Every block starts with a
+ * header holding its own size and the size of the block just below it, so
+ * a freed block is merged at once with free neighbours on both sides, and
+ * given back to the top of the segment if it ends there. Free blocks wait
+ * in exact-size lists up to 1 KiB and in one first-fit list above that; a
+ * request takes the first free block large enough (the exact list, the
+ * larger small lists, then the large list), splits off the rest as a new
+ * free block of its own size, and only then takes new memory from the top.
+ * Named objects are recorded in a small directory so other processes can
+ * find them. Allocation is guarded by a robust process-shared mutex.
+ */
+struct shm_header {
+    static constexpr uint64_t MAGIC = 0x4d48532d55544a53ULL; // "SJTU-SHM"
+    static constexpr size_t   ALIGN = 16;
+    static constexpr size_t   BINS = 64;    // free lists for blocks of 16, 32, ..., 1024 bytes
+    static constexpr size_t   NAME_LEN = 48;
+    static constexpr size_t   MAX_NAMES = 32;
+
+    struct block {
+        size_t prev_size; // of the block just below, 0 for the first block
+        size_t size;      // of this block with its header, bit 0 is set while in use
+    };
+    struct free_block : block {
+        offset_ptr<free_block> next;
+        offset_ptr<free_block> prev;
+    };
+    static constexpr size_t HEADER = sizeof(block);
+    static constexpr size_t MIN_BLOCK = (sizeof(free_block) + ALIGN - 1) / ALIGN * ALIGN;
+    static constexpr size_t USED = 1;
+
+    struct entry {
+        char             name[NAME_LEN];
+        offset_ptr<void> object;
+        size_t           bytes;
+    };
+
+    uint64_t               magic;
+    size_t                 size;          // total bytes of the segment
+    size_t                 top;           // offset of the first byte never handed out
+    size_t                 top_prev_size; // size of the block just below top, 0 if none
+    pthread_mutex_t        lock;
+    offset_ptr<free_block> bins[BINS];
+    offset_ptr<free_block> large;
+    entry                  names[MAX_NAMES];
+
+    /**
+     * locks the mutex. If its owner died while holding it, the lock is taken
+     * over and marked consistent, what the owner was doing is not undone.
+     */
+    struct guard {
+        pthread_mutex_t *m;
+        explicit guard(pthread_mutex_t *_m) : m(_m) {
+            if (pthread_mutex_lock(m) == EOWNERDEAD) pthread_mutex_consistent(m);
+        }
+        ~guard() { pthread_mutex_unlock(m); }
+    };
+
+    static size_t round_up(size_t bytes) {
+        return bytes == 0 ? ALIGN : (bytes + ALIGN - 1) / ALIGN * ALIGN;
+    }
+
+    void init(size_t bytes) {
+        size = bytes;
+        top = first();
+        top_prev_size = 0;
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&lock, &attr);
+        pthread_mutexattr_destroy(&attr);
+        for (size_t i = 0; i < BINS; ++i) bins[i] = nullptr;
+        large = nullptr;
+        for (size_t i = 0; i < MAX_NAMES; ++i) {
+            names[i].name[0] = '\0';
+            names[i].object = nullptr;
+        }
+        magic = MAGIC;
+    }
+
+    char *base() {
+        return reinterpret_cast<char *>(this);
+    }
+
+    /**
+     * allocate bytes aligned to ALIGN inside the segment,
+     * throw runtime_error if the segment is full.
+     */
+    void *allocate(size_t bytes) {
+        size_t need = round_up(bytes) + HEADER;
+        if (need < MIN_BLOCK) need = MIN_BLOCK;
+        guard g(&lock);
+        free_block *b = nullptr;
+        for (size_t i = need / ALIGN - 1; i < BINS && !b; ++i) b = bins[i];
+        for (free_block *x = large; x && !b; x = x->next) {
+            if (x->size >= need) b = x;
+        }
+        if (b) {
+            unlink(b);
+            split(b, need);
+        } else {
+            if (top + need > size) throw runtime_error();
+            b = reinterpret_cast<free_block *>(base() + top);
+            b->prev_size = top_prev_size;
+            b->size = need;
+            top += need;
+            top_prev_size = need;
+        }
+        b->size |= USED;
+        return reinterpret_cast<char *>(b) + HEADER;
+    }
+
+    /**
+     * release a block of allocate(), the size is read from its header
+     * so bytes is only kept for the allocator interface.
+     */
+    void deallocate(void *p, size_t bytes) {
+        (void)bytes;
+        if (p == nullptr) return;
+        guard g(&lock);
+        free_block *b = reinterpret_cast<free_block *>(static_cast<char *>(p) - HEADER);
+        size_t sz = b->size & ~USED;
+        block *next = reinterpret_cast<block *>(reinterpret_cast<char *>(b) + sz);
+        if (offset(next) < top && !(next->size & USED)) {
+            unlink(static_cast<free_block *>(next));
+            sz += next->size;
+        }
+        if (b->prev_size != 0) {
+            block *prev = reinterpret_cast<block *>(reinterpret_cast<char *>(b) - b->prev_size);
+            if (!(prev->size & USED)) {
+                unlink(static_cast<free_block *>(prev));
+                sz += prev->size;
+                b = static_cast<free_block *>(prev);
+            }
+        }
+        if (offset(b) + sz == top) {
+            // back to the untouched memory, the block below is in use
+            top = offset(b);
+            top_prev_size = b->prev_size;
+            return;
+        }
+        b->size = sz;
+        set_prev_size(b);
+        push(b);
+    }
+
+    size_t first() const {
+        return round_up(sizeof(shm_header));
+    }
+    size_t offset(const void *p) {
+        return static_cast<const char *>(p) - base();
+    }
+    offset_ptr<free_block> &list_for(size_t sz) {
+        return sz / ALIGN <= BINS ? bins[sz / ALIGN - 1] : large;
+    }
+    // tell the block above b (or top) the size of b
+    void set_prev_size(block *b) {
+        size_t sz = b->size & ~USED;
+        if (offset(b) + sz == top) top_prev_size = sz;
+        else reinterpret_cast<block *>(reinterpret_cast<char *>(b) + sz)->prev_size = sz;
+    }
+    void push(free_block *b) {
+        offset_ptr<free_block> &head = list_for(b->size);
+        b->prev = nullptr;
+        b->next = head;
+        if (b->next) b->next->prev = b;
+        head = b;
+    }
+    void unlink(free_block *b) {
+        if (b->prev) b->prev->next = b->next;
+        else list_for(b->size) = b->next;
+        if (b->next) b->next->prev = b->prev;
+    }
+    // shrink the free block b to need bytes, the rest becomes a free block
+    void split(free_block *b, size_t need) {
+        if (b->size - need < MIN_BLOCK) return;
+        free_block *rest = reinterpret_cast<free_block *>(reinterpret_cast<char *>(b) + need);
+        rest->prev_size = need;
+        rest->size = b->size - need;
+        b->size = need;
+        set_prev_size(rest);
+        push(rest);
+    }
+
+    entry *lookup(const char *name) {
+        for (size_t i = 0; i < MAX_NAMES; ++i) {
+            if (names[i].object && std::strncmp(names[i].name, name, NAME_LEN) == 0) return names + i;
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * an allocator handing out memory of a shm_segment through offset_ptr,
+ * containers using it must be constructed inside the same segment.
+ */
+template<typename T>
+class shm_allocator {
+    template<typename U> friend class shm_allocator;
+
+  private:
+    offset_ptr<shm_header> m_header;
+
+  public:
+    using value_type = T;
+    using pointer = offset_ptr<T>;
+    using const_pointer = offset_ptr<const T>;
+    using void_pointer = offset_ptr<void>;
+    using const_void_pointer = offset_ptr<const void>;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    explicit shm_allocator(shm_header *header) : m_header(header) {}
+    shm_allocator(const shm_allocator &other) : m_header(other.m_header) {}
+    template<typename U>
+    shm_allocator(const shm_allocator<U> &other) : m_header(other.m_header) {}
+    shm_allocator &operator=(const shm_allocator &other) {
+        m_header = other.m_header;
+        return *this;
+    }
+
+    pointer allocate(size_t n) {
+        static_assert(alignof(T) <= shm_header::ALIGN, "over-aligned types are not supported in shared memory");
+        return pointer(static_cast<T *>(m_header->allocate(n * sizeof(T))));
+    }
+    void deallocate(pointer p, size_t n) {
+        m_header->deallocate(p.get(), n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const shm_allocator<U> &rhs) const {
+        return m_header.get() == rhs.m_header.get();
+    }
+    template<typename U>
+    bool operator!=(const shm_allocator<U> &rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+/**
+ * a POSIX shared memory segment (shm_open + mmap) mapped into this process.
+ *
+ * one process creates the segment and builds the containers in it,
+ * other processes open it, by default read-only, and find the containers
+ * by name. Anything stored inside must not hold raw pointers: use
+ * containers with shm_allocator, whose links are offset_ptr.
+ *
+ * throw runtime_error if the segment cannot be created / opened.
+ */
+class shm_segment {
+  private:
+    int         m_fd;
+    shm_header *m_header;
+    size_t      m_size;
+    bool        m_read_only;
+
+    shm_segment(int fd, shm_header *header, size_t size, bool read_only)
+        : m_fd(fd), m_header(header), m_size(size), m_read_only(read_only) {}
+
+  public:
+    /**
+     * create a new segment of the given size, fail if the name exists.
+     */
+    static shm_segment create(const char *name, size_t bytes) {
+        bytes = shm_header::round_up(bytes < sizeof(shm_header) * 2 ? sizeof(shm_header) * 2 : bytes);
+        int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw runtime_error();
+        if (ftruncate(fd, bytes) != 0) {
+            close(fd);
+            shm_unlink(name);
+            throw runtime_error();
+        }
+        void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            shm_unlink(name);
+            throw runtime_error();
+        }
+        shm_header *header = static_cast<shm_header *>(p);
+        header->init(bytes);
+        return shm_segment(fd, header, bytes, false);
+    }
+    /**
+     * attach to an existing segment.
+     * a read-only segment may only be used for lookups.
+     */
+    static shm_segment open(const char *name, bool read_only = true) {
+        int fd = shm_open(name, read_only ? O_RDONLY : O_RDWR, 0);
+        if (fd < 0) throw runtime_error();
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(shm_header)) {
+            close(fd);
+            throw runtime_error();
+        }
+        size_t bytes = st.st_size;
+        void *p = mmap(nullptr, bytes, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            throw runtime_error();
+        }
+        shm_header *header = static_cast<shm_header *>(p);
+        if (header->magic != shm_header::MAGIC) {
+            munmap(p, bytes);
+            close(fd);
+            throw runtime_error();
+        }
+        return shm_segment(fd, header, bytes, read_only);
+    }
+    /**
+     * remove the name of a segment, processes attached to it keep their mapping.
+     */
+    static bool remove(const char *name) {
+        return shm_unlink(name) == 0;
+    }
+
+    shm_segment(const shm_segment &) = delete;
+    shm_segment &operator=(const shm_segment &) = delete;
+    shm_segment(shm_segment &&other) noexcept
+        : m_fd(other.m_fd), m_header(other.m_header), m_size(other.m_size), m_read_only(other.m_read_only) {
+        other.m_fd = -1;
+        other.m_header = nullptr;
+    }
+    ~shm_segment() {
+        if (m_header) munmap(m_header, m_size);
+        if (m_fd >= 0) close(m_fd);
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+    bool read_only() const {
+        return m_read_only;
+    }
+    /**
+     * an allocator for containers built inside this segment.
+     */
+    template<typename T>
+    shm_allocator<T> get_allocator() const {
+        return shm_allocator<T>(m_header);
+    }
+    /**
+     * construct an object of type T named name in the segment.
+     * throw runtime_error if the segment is read-only, full or the name is taken.
+     */
+    template<typename T, typename... Args>
+    T *construct(const char *name, Args &&...args) {
+        if (m_read_only || std::strlen(name) >= shm_header::NAME_LEN) throw runtime_error();
+        shm_header::entry *slot = nullptr;
+        {
+            shm_header::guard g(&m_header->lock);
+            if (m_header->lookup(name)) throw runtime_error();
+            for (size_t i = 0; i < shm_header::MAX_NAMES && !slot; ++i) {
+                if (!m_header->names[i].object) slot = m_header->names + i;
+            }
+            if (!slot) throw runtime_error();
+            // reserve the slot before the object exists, so it is never handed out twice
+            std::memcpy(slot->name, name, std::strlen(name) + 1); // the length was checked above
+            slot->object = m_header;
+        }
+        void *p = nullptr;
+        try {
+            p = m_header->allocate(sizeof(T));
+            T *obj = std::construct_at(static_cast<T *>(p), std::forward<Args>(args)...);
+            slot->bytes = sizeof(T);
+            slot->object = obj;
+            return obj;
+        } catch (...) {
+            m_header->deallocate(p, sizeof(T));
+            slot->object = nullptr;
+            throw;
+        }
+    }
+    /**
+     * find the object named name, return nullptr if there is none.
+     */
+    template<typename T>
+    T *find(const char *name) const {
+        shm_header::entry *e = m_header->lookup(name);
+        if (!e || e->object.get() == m_header) return nullptr;
+        return static_cast<T *>(e->object.get());
+    }
+    /**
+     * destroy the object named name and release its memory.
+     */
+    template<typename T>
+    bool destroy(const char *name) {
+        if (m_read_only) throw runtime_error();
+        T *obj = find<T>(name);
+        if (!obj) return false;
+        std::destroy_at(obj);
+        m_header->deallocate(obj, sizeof(T));
+        shm_header::guard g(&m_header->lock);
+        m_header->lookup(name)->object = nullptr;
+        return true;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef SJTU_SHM_VECTOR_HPP
+#define SJTU_SHM_VECTOR_HPP
+
+#include "vector.hpp"
+#include "shared_memory.hpp"
+
+namespace sjtu {
+/**
+ * a vector living in a shm_segment, shared by several processes.
+ *
+ * the buffer is allocated in the segment and referred to by an offset_ptr,
+ * so it is valid wherever the segment is mapped. T must not hold raw pointers.
+ *
+ *   auto seg = sjtu::shm_segment::create("/table", 64 << 20);
+ *   auto *v = seg.construct<sjtu::shm_vector<int>>("ids", seg.get_allocator<int>());
+ *   ...
+ *   auto ro = sjtu::shm_segment::open("/table");   // in another process
+ *   const auto *t = ro.find<sjtu::shm_vector<int>>("ids");
+ *
+ * writes are not synchronized: build the vector in one process, the others
+ * attach read-only and only read it.
+ */
+template<typename T>
+using shm_vector = vector<T, shm_allocator<T>>;
+
+}
+
+#endif
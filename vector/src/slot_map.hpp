@@ -0,0 +1,207 @@
+#ifndef SJTU_SLOT_MAP_HPP
+#define SJTU_SLOT_MAP_HPP
+
+#include "vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace sjtu {
+/**
+ * a registry which hands out a key for every inserted value,
+ * with O(1) insert, erase and lookup by key.
+ *
+ * the values are kept densely in a vector (so iterating them is a plain scan),
+ * and a key is an (index, generation) handle into a table of slots, each slot
+ * holding where its value currently is. Erasing moves the last value into the
+ * hole and bumps the generation of the slot, which is then reused by a later
+ * insert with yet another generation, so a stale key is detected instead of
+ * reaching the new value. A generation is odd while its slot is in use.
+ */
+template<typename T>
+class slot_map {
+  public:
+    struct key {
+        uint32_t index;
+        uint32_t generation;
+
+        bool operator==(const key &rhs) const = default;
+    };
+    using iterator = typename vector<T>::iterator;
+    using const_iterator = typename vector<T>::const_iterator;
+
+  private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct slot {
+        uint32_t pos;        // index in _m_values, or the next free slot
+        uint32_t generation; // bumped on every insert and erase, odd while in use
+    };
+
+    vector<T>        _m_values;
+    vector<uint32_t> _m_owner; // _m_owner[i] is the slot of _m_values[i]
+    vector<slot>     _m_slots;
+    uint32_t         _m_free_head;
+
+  public:
+    /**
+     * constructors
+     */
+    slot_map() : _m_free_head(NONE) {}
+    /**
+     * returns the number of values
+     */
+    size_t size() const {
+        return _m_values.size();
+    }
+    /**
+     * checks whether the container is empty
+     */
+    bool empty() const {
+        return _m_values.empty();
+    }
+    /**
+     * inserts a value, returns its key.
+     */
+    key insert(const T &value) {
+        return emplace(value);
+    }
+    key insert(T &&value) {
+        return emplace(std::move(value));
+    }
+    template<typename... Args>
+    key emplace(Args &&...args) {
+        T value(std::forward<Args>(args)...); // args may refer to a value, which can move below
+        // the slot and the owner entry come first, so if a push_back throws nothing is left behind
+        uint32_t s = _m_free_head;
+        bool new_slot = s == NONE;
+        if (new_slot) {
+            s = _m_slots.size();
+            _m_slots.push_back({0, 0});
+        }
+        try {
+            _m_owner.push_back(s);
+            try {
+                _m_values.push_back(std::move(value));
+            } catch (...) {
+                _m_owner.pop_back();
+                throw;
+            }
+        } catch (...) {
+            if (new_slot) _m_slots.pop_back();
+            throw;
+        }
+        if (!new_slot) _m_free_head = _m_slots[s].pos;
+        _m_slots[s].pos = _m_values.size() - 1;
+        ++_m_slots[s].generation;
+        return {s, _m_slots[s].generation};
+    }
+    /**
+     * checks whether k refers to a value which has not been erased
+     */
+    bool contains(const key &k) const {
+        return (k.generation & 1) && k.index < _m_slots.size() && _m_slots[k.index].generation == k.generation;
+    }
+    /**
+     * returns a pointer to the value of k, nullptr if k is stale.
+     */
+    T *find(const key &k) {
+        return contains(k) ? &_m_values[_m_slots[k.index].pos] : nullptr;
+    }
+    const T *find(const key &k) const {
+        return contains(k) ? &_m_values[_m_slots[k.index].pos] : nullptr;
+    }
+    /**
+     * access the value of k.
+     * throw index_out_of_bound if k is stale
+     */
+    T &at(const key &k) {
+        if (!contains(k)) throw index_out_of_bound();
+        return _m_values[_m_slots[k.index].pos];
+    }
+    const T &at(const key &k) const {
+        if (!contains(k)) throw index_out_of_bound();
+        return _m_values[_m_slots[k.index].pos];
+    }
+    T &operator[](const key &k) {
+        return at(k);
+    }
+    const T &operator[](const key &k) const {
+        return at(k);
+    }
+    /**
+     * removes the value of k by moving the last value into its place.
+     * returns the number of values removed (0 if k is stale).
+     */
+    size_t erase(const key &k) {
+        if (!contains(k)) return 0;
+        uint32_t pos = _m_slots[k.index].pos, last = _m_values.size() - 1;
+        if (pos != last) {
+            _m_values[pos] = std::move(_m_values[last]);
+            _m_owner[pos] = _m_owner[last];
+            _m_slots[_m_owner[pos]].pos = pos;
+        }
+        _m_values.pop_back();
+        _m_owner.pop_back();
+        ++_m_slots[k.index].generation;
+        _m_slots[k.index].pos = _m_free_head;
+        _m_free_head = k.index;
+        return 1;
+    }
+    /**
+     * clears the contents, every key handed out before becomes stale.
+     */
+    void clear() {
+        for (size_t i = 0; i < _m_owner.size(); ++i) {
+            uint32_t s = _m_owner[i];
+            ++_m_slots[s].generation;
+            _m_slots[s].pos = _m_free_head;
+            _m_free_head = s;
+        }
+        _m_values.clear();
+        _m_owner.clear();
+    }
+    /**
+     * the key of the value at position pos of the dense array.
+     * throw index_out_of_bound if pos is not in [0, size)
+     */
+    key key_at(size_t pos) const {
+        uint32_t s = _m_owner.at(pos);
+        return {s, _m_slots[s].generation};
+    }
+    /**
+     * iterators over the values in their dense order, invalidated by insert / erase.
+     */
+    iterator begin() {
+        return _m_values.begin();
+    }
+    const_iterator begin() const {
+        return _m_values.cbegin();
+    }
+    const_iterator cbegin() const {
+        return _m_values.cbegin();
+    }
+    iterator end() {
+        return _m_values.end();
+    }
+    const_iterator end() const {
+        return _m_values.cend();
+    }
+    const_iterator cend() const {
+        return _m_values.cend();
+    }
+    /**
+     * returns a pointer to the dense array of values.
+     */
+    T *data() {
+        return _m_values.data();
+    }
+    const T *data() const {
+        return _m_values.data();
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef SJTU_STATIC_INDEX_HPP
+#define SJTU_STATIC_INDEX_HPP
+
+#include "vector.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+
+namespace sjtu {
+/**
+ * a read-only search index built once from a sorted sjtu::vector.
+ *
+ * keys are stored in Eytzinger (BFS) order: node k has children 2k and 2k+1,
+ * so the first levels of every search share a few cache lines. The descent
+ * is branchless (k = 2k + (key < x)) and prefetches the cache line holding
+ * the descendants a few levels below, which hides most of the misses in the
+ * lower levels. Queries return ranks into the vector the index was built from.
+ */
+template<typename T, class Compare = std::less<T>>
+class static_index {
+  private:
+    static constexpr size_t CACHE_LINE = 64;
+    // descendants of node k that are BLOCK levels below lie in [k * BLOCK, k * BLOCK + BLOCK)
+    static constexpr size_t BLOCK = sizeof(T) >= CACHE_LINE ? 1 : std::bit_floor(CACHE_LINE / sizeof(T));
+
+    T *_m_tree;       // _m_tree[1 .. _m_size] in BFS order, _m_tree[0] unused
+    size_t *_m_rank;  // _m_rank[k] is the index of _m_tree[k] in the sorted vector
+    size_t _m_size;
+
+  public:
+    /**
+     * constructors
+     */
+    static_index() : _m_tree(nullptr), _m_rank(nullptr), _m_size(0) {}
+    /**
+     * build the index from a vector sorted by Compare.
+     */
+    explicit static_index(const vector<T> &sorted) : static_index() {
+        _build(sorted.data(), sorted.size());
+    }
+    static_index(const static_index &other) : static_index() {
+        size_t n = other._m_size;
+        _allocate(n);
+        for (size_t k = 1; k <= n; ++k) _m_rank[k] = other._m_rank[k];
+        _construct(n, [&](size_t k) -> const T & { return other._m_tree[k]; });
+    }
+    /**
+     * destructor
+     */
+    ~static_index() {
+        _release();
+    }
+    /**
+     * assignment operator
+     */
+    static_index &operator=(const static_index &other) {
+        if (this == &other) return *this;
+        static_index tmp(other);
+        std::swap(_m_tree, tmp._m_tree);
+        std::swap(_m_rank, tmp._m_rank);
+        std::swap(_m_size, tmp._m_size);
+        return *this;
+    }
+    /**
+     * returns the number of keys
+     */
+    size_t size() const {
+        return _m_size;
+    }
+    /**
+     * checks whether the index is empty
+     */
+    bool empty() const {
+        return _m_size == 0;
+    }
+    /**
+     * returns the rank of the first key which is not less than x,
+     *   that is what std::lower_bound returns on the sorted vector.
+     * returns size() if there is no such key.
+     */
+    size_t lower_bound(const T &x) const {
+        size_t k = 1;
+        while (k <= _m_size) {
+            __builtin_prefetch(_m_tree + k * BLOCK);
+            k = 2 * k + static_cast<size_t>(Compare()(_m_tree[k], x));
+        }
+        return _rank_of(k);
+    }
+    /**
+     * returns the rank of the first key which is greater than x,
+     * returns size() if there is no such key.
+     */
+    size_t upper_bound(const T &x) const {
+        size_t k = 1;
+        while (k <= _m_size) {
+            __builtin_prefetch(_m_tree + k * BLOCK);
+            k = 2 * k + static_cast<size_t>(!Compare()(x, _m_tree[k]));
+        }
+        return _rank_of(k);
+    }
+    /**
+     * checks whether a key equivalent to x exists
+     */
+    bool contains(const T &x) const {
+        size_t r = lower_bound(x);
+        return r != _m_size && !Compare()(x, at_rank(r));
+    }
+    /**
+     * returns the key with rank r (the r-th element of the sorted vector),
+     * throw index_out_of_bound if r is not in [0, size)
+     */
+    const T &at_rank(size_t r) const {
+        if (r >= _m_size) throw index_out_of_bound();
+        return _m_tree[_node_of(r)];
+    }
+
+  private:
+    /**
+     * the descent stopped below a leaf, the answer is the last node where we went left:
+     * drop the trailing ones (right turns) and the final left turn.
+     */
+    size_t _rank_of(size_t k) const {
+        k >>= std::countr_one(k) + 1;
+        return k == 0 ? _m_size : _m_rank[k];
+    }
+    /**
+     * the node holding rank r, found by the same descent over ranks.
+     */
+    size_t _node_of(size_t r) const {
+        size_t k = 1;
+        while (_m_rank[k] != r) k = 2 * k + (_m_rank[k] < r);
+        return k;
+    }
+    // raw memory for n keys, _m_size stays 0 until the keys are constructed
+    void _allocate(size_t n) {
+        if (n == 0) return;
+        _m_tree = static_cast<T *>(::operator new((n + 1) * sizeof(T), std::align_val_t(CACHE_LINE)));
+        try {
+            _m_rank = new size_t[n + 1];
+        } catch (...) {
+            _deallocate();
+            throw;
+        }
+    }
+    void _deallocate() {
+        if (_m_tree) ::operator delete(_m_tree, std::align_val_t(CACHE_LINE));
+        delete[] _m_rank;
+        _m_tree = nullptr;
+        _m_rank = nullptr;
+    }
+    // construct _m_tree[1 .. n] from key(k) in order of k.
+    // if a copy throws the keys built so far are destroyed and the memory is released
+    template<typename F>
+    void _construct(size_t n, F key) {
+        size_t k = 1;
+        try {
+            for (; k <= n; ++k) std::construct_at(_m_tree + k, key(k));
+        } catch (...) {
+            while (--k > 0) std::destroy_at(_m_tree + k);
+            _deallocate();
+            throw;
+        }
+        _m_size = n;
+    }
+    void _release() {
+        for (size_t k = 1; k <= _m_size; ++k) std::destroy_at(_m_tree + k);
+        _deallocate();
+        _m_size = 0;
+    }
+    void _build(const T *sorted, size_t n) {
+        _allocate(n);
+        size_t i = 0;
+        _fill_ranks(n, i, 1);
+        _construct(n, [&](size_t k) -> const T & { return sorted[_m_rank[k]]; });
+    }
+    // in-order walk of the implicit tree, so node k receives the i-th smallest key
+    void _fill_ranks(size_t n, size_t &i, size_t k) {
+        if (k > n) return;
+        _fill_ranks(n, i, 2 * k);
+        _m_rank[k] = i++;
+        _fill_ranks(n, i, 2 * k + 1);
+    }
+};
+
+}
+
+#endif
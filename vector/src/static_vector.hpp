@@ -0,0 +1,382 @@
+#ifndef SJTU_STATIC_VECTOR_HPP
+#define SJTU_STATIC_VECTOR_HPP
+
+#include "exceptions.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+/**
+ * a container like sjtu::vector with a fixed capacity N,
+ * the elements are stored inside the object and it never allocates.
+ *
+ * it is trivially copyable if T is, so it can be memcpy-ed inside messages,
+ * and it can be used in constant evaluation.
+ */
+template<typename T, size_t N>
+class static_vector {
+    static_assert(N > 0, "static_vector needs a positive capacity");
+
+  private:
+    // uninitialized storage for N elements, the elements are constructed on demand
+    union storage {
+        char _m_none;
+        T    _m_elems[N];
+
+        constexpr storage() : _m_none() {}
+        constexpr storage(const storage &) = default;
+        constexpr storage &operator=(const storage &) = default;
+        constexpr ~storage() requires std::is_trivially_destructible_v<T> = default;
+        constexpr ~storage() {}
+    };
+
+    storage _m_store;
+    size_t  _m_size;
+
+  public:
+    class const_iterator;
+    class iterator {
+      public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
+        friend class static_vector;
+
+      private:
+        T *_m_ptr;
+        constexpr explicit iterator(T *_ptr) : _m_ptr(_ptr) {}
+
+      public:
+        constexpr iterator() : _m_ptr(nullptr) {}
+        constexpr iterator operator+(const difference_type &n) const {
+            return iterator(_m_ptr + n);
+        }
+        friend constexpr iterator operator+(const difference_type &n, const iterator &it) {
+            return it + n;
+        }
+        constexpr iterator operator-(const difference_type &n) const {
+            return iterator(_m_ptr - n);
+        }
+        constexpr difference_type operator-(const iterator &rhs) const {
+            return _m_ptr - rhs._m_ptr;
+        }
+        constexpr iterator &operator+=(const difference_type &n) {
+            _m_ptr += n;
+            return *this;
+        }
+        constexpr iterator &operator-=(const difference_type &n) {
+            _m_ptr -= n;
+            return *this;
+        }
+        constexpr iterator operator++(int) {
+            auto tmp = *this;
+            ++_m_ptr;
+            return tmp;
+        }
+        constexpr iterator &operator++() {
+            ++_m_ptr;
+            return *this;
+        }
+        constexpr iterator operator--(int) {
+            auto tmp = *this;
+            --_m_ptr;
+            return tmp;
+        }
+        constexpr iterator &operator--() {
+            --_m_ptr;
+            return *this;
+        }
+        constexpr T &operator*() const {
+            return *_m_ptr;
+        }
+        constexpr T *operator->() const {
+            return _m_ptr;
+        }
+        constexpr T &operator[](const difference_type &n) const {
+            return _m_ptr[n];
+        }
+        constexpr bool operator==(const iterator &rhs) const {
+            return _m_ptr == rhs._m_ptr;
+        }
+        constexpr bool operator!=(const iterator &rhs) const {
+            return _m_ptr != rhs._m_ptr;
+        }
+        constexpr auto operator<=>(const iterator &rhs) const {
+            return _m_ptr <=> rhs._m_ptr;
+        }
+    };
+    class const_iterator {
+      public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
+        friend class static_vector;
+
+      private:
+        const T *_m_cptr;
+        constexpr explicit const_iterator(const T *_ptr) : _m_cptr(_ptr) {}
+
+      public:
+        constexpr const_iterator() : _m_cptr(nullptr) {}
+        constexpr const_iterator(const iterator &other) : _m_cptr(other._m_ptr) {}
+        constexpr const_iterator operator+(const difference_type &n) const {
+            return const_iterator(_m_cptr + n);
+        }
+        friend constexpr const_iterator operator+(const difference_type &n, const const_iterator &it) {
+            return it + n;
+        }
+        constexpr const_iterator operator-(const difference_type &n) const {
+            return const_iterator(_m_cptr - n);
+        }
+        constexpr difference_type operator-(const const_iterator &rhs) const {
+            return _m_cptr - rhs._m_cptr;
+        }
+        constexpr const_iterator &operator+=(const difference_type &n) {
+            _m_cptr += n;
+            return *this;
+        }
+        constexpr const_iterator &operator-=(const difference_type &n) {
+            _m_cptr -= n;
+            return *this;
+        }
+        constexpr const_iterator operator++(int) {
+            auto tmp = *this;
+            ++_m_cptr;
+            return tmp;
+        }
+        constexpr const_iterator &operator++() {
+            ++_m_cptr;
+            return *this;
+        }
+        constexpr const_iterator operator--(int) {
+            auto tmp = *this;
+            --_m_cptr;
+            return tmp;
+        }
+        constexpr const_iterator &operator--() {
+            --_m_cptr;
+            return *this;
+        }
+        constexpr const T &operator*() const {
+            return *_m_cptr;
+        }
+        constexpr const T *operator->() const {
+            return _m_cptr;
+        }
+        constexpr const T &operator[](const difference_type &n) const {
+            return _m_cptr[n];
+        }
+        constexpr bool operator==(const const_iterator &rhs) const {
+            return _m_cptr == rhs._m_cptr;
+        }
+        constexpr bool operator!=(const const_iterator &rhs) const {
+            return _m_cptr != rhs._m_cptr;
+        }
+        constexpr auto operator<=>(const const_iterator &rhs) const {
+            return _m_cptr <=> rhs._m_cptr;
+        }
+    };
+    /**
+     * constructors
+     * the copy / move operations are trivial if T is trivially copyable.
+     */
+    constexpr static_vector() : _m_store(), _m_size(0) {}
+    constexpr static_vector(const static_vector &other) requires std::is_trivially_copyable_v<T> = default;
+    constexpr static_vector(const static_vector &other) : _m_store(), _m_size(0) {
+        for (size_t i = 0; i < other._m_size; ++i) push_back(other[i]);
+    }
+    constexpr static_vector(static_vector &&other) requires std::is_trivially_copyable_v<T> = default;
+    constexpr static_vector(static_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : _m_store(), _m_size(0) {
+        for (size_t i = 0; i < other._m_size; ++i) push_back(std::move(other[i]));
+    }
+    /**
+     * destructor
+     */
+    constexpr ~static_vector() requires std::is_trivially_destructible_v<T> = default;
+    constexpr ~static_vector() {
+        clear();
+    }
+    /**
+     * assignment operators
+     */
+    constexpr static_vector &operator=(const static_vector &other) requires std::is_trivially_copyable_v<T> = default;
+    constexpr static_vector &operator=(const static_vector &other) {
+        if (this == &other) return *this;
+        clear();
+        for (size_t i = 0; i < other._m_size; ++i) push_back(other[i]);
+        return *this;
+    }
+    constexpr static_vector &operator=(static_vector &&other) requires std::is_trivially_copyable_v<T> = default;
+    constexpr static_vector &operator=(static_vector &&other) {
+        if (this == &other) return *this;
+        clear();
+        for (size_t i = 0; i < other._m_size; ++i) push_back(std::move(other[i]));
+        return *this;
+    }
+    /**
+     * assigns specified element with bounds checking
+     * throw index_out_of_bound if pos is not in [0, size)
+     */
+    constexpr T &at(const size_t &pos) {
+        if (pos >= _m_size) throw index_out_of_bound();
+        return _m_store._m_elems[pos];
+    }
+    constexpr const T &at(const size_t &pos) const {
+        if (pos >= _m_size) throw index_out_of_bound();
+        return _m_store._m_elems[pos];
+    }
+    constexpr T &operator[](const size_t &pos) {
+        return at(pos);
+    }
+    constexpr const T &operator[](const size_t &pos) const {
+        return at(pos);
+    }
+    /**
+     * access the first / last element.
+     * throw container_is_empty if size == 0
+     */
+    constexpr const T &front() const {
+        if (_m_size == 0) throw container_is_empty();
+        return _m_store._m_elems[0];
+    }
+    constexpr const T &back() const {
+        if (_m_size == 0) throw container_is_empty();
+        return _m_store._m_elems[_m_size - 1];
+    }
+    /**
+     * returns a pointer to the underlying array.
+     */
+    constexpr T *data() {
+        return _m_store._m_elems;
+    }
+    constexpr const T *data() const {
+        return _m_store._m_elems;
+    }
+    /**
+     * iterators to the beginning and the end.
+     */
+    constexpr iterator begin() {
+        return iterator(_m_store._m_elems);
+    }
+    constexpr const_iterator begin() const {
+        return const_iterator(_m_store._m_elems);
+    }
+    constexpr const_iterator cbegin() const {
+        return const_iterator(_m_store._m_elems);
+    }
+    constexpr iterator end() {
+        return iterator(_m_store._m_elems + _m_size);
+    }
+    constexpr const_iterator end() const {
+        return const_iterator(_m_store._m_elems + _m_size);
+    }
+    constexpr const_iterator cend() const {
+        return const_iterator(_m_store._m_elems + _m_size);
+    }
+    /**
+     * checks whether the container is empty / full
+     */
+    constexpr bool empty() const {
+        return _m_size == 0;
+    }
+    constexpr bool full() const {
+        return _m_size == N;
+    }
+    /**
+     * returns the number of elements
+     */
+    constexpr size_t size() const {
+        return _m_size;
+    }
+    /**
+     * returns the fixed capacity N.
+     */
+    static constexpr size_t capacity() {
+        return N;
+    }
+    /**
+     * clears the contents
+     */
+    constexpr void clear() {
+        for (size_t i = 0; i < _m_size; ++i) std::destroy_at(_m_store._m_elems + i);
+        _m_size = 0;
+    }
+    /**
+     * inserts value before pos / at index ind.
+     * returns an iterator pointing to the inserted value.
+     * throw index_out_of_bound if ind > size or the container is full.
+     */
+    constexpr iterator insert(iterator pos, const T &value) {
+        return insert(pos - begin(), value);
+    }
+    constexpr iterator insert(const size_t &ind, const T &value) {
+        if (ind > _m_size || _m_size == N) throw index_out_of_bound();
+        if (ind == _m_size) {
+            push_back(value);
+            return iterator(_m_store._m_elems + ind);
+        }
+        T tmp(value); // value may refer to an element which is moved below
+        T *elems = _m_store._m_elems;
+        std::construct_at(elems + _m_size, std::move(elems[_m_size - 1]));
+        for (size_t i = _m_size - 1; i > ind; --i) elems[i] = std::move(elems[i - 1]);
+        elems[ind] = std::move(tmp);
+        ++_m_size;
+        return iterator(elems + ind);
+    }
+    /**
+     * removes the element at pos / with index ind.
+     * return an iterator pointing to the following element.
+     * throw index_out_of_bound if ind >= size
+     */
+    constexpr iterator erase(iterator pos) {
+        return erase(pos - begin());
+    }
+    constexpr iterator erase(const size_t &ind) {
+        if (ind >= _m_size) throw index_out_of_bound();
+        T *elems = _m_store._m_elems;
+        for (size_t i = ind; i + 1 < _m_size; ++i) elems[i] = std::move(elems[i + 1]);
+        std::destroy_at(elems + --_m_size);
+        return iterator(elems + ind);
+    }
+    /**
+     * adds an element to the end.
+     * throw index_out_of_bound if the container is full.
+     */
+    constexpr void push_back(const T &value) {
+        emplace_back(value);
+    }
+    constexpr void push_back(T &&value) {
+        emplace_back(std::move(value));
+    }
+    template<typename... Args>
+    constexpr T &emplace_back(Args &&...args) {
+        if (_m_size == N) throw index_out_of_bound();
+        T *p = std::construct_at(_m_store._m_elems + _m_size, std::forward<Args>(args)...);
+        ++_m_size;
+        return *p;
+    }
+    /**
+     * remove the last element from the end.
+     * throw container_is_empty if size() == 0
+     */
+    constexpr void pop_back() {
+        if (_m_size == 0) throw container_is_empty();
+        std::destroy_at(_m_store._m_elems + --_m_size);
+    }
+};
+
+}
+
+#endif
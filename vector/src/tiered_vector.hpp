@@ -0,0 +1,466 @@
+#ifndef SJTU_TIERED_VECTOR_HPP
+#define SJTU_TIERED_VECTOR_HPP
+
+#include "vector.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace sjtu {
+/**
+ * a sequence with O(1) random access and O(sqrt n) insert / erase anywhere.
+ *
+ * the elements live in blocks of B slots (B a power of two close to sqrt n),
+ * every block is a circular buffer and every block but the last one is full,
+ * so element i is slot i % B of block i / B. Inserting into block k shifts
+ * at most B elements inside it, then every later block passes its last element
+ * to the front of the next one in O(1). Erasing works the other way round.
+ * The blocks are rebuilt with a doubled / halved B when n leaves [B^2 / 8, 2 B^2].
+ */
+template<typename T>
+class tiered_vector {
+  private:
+    static constexpr size_t MIN_BLOCK = 16;
+
+    // a circular buffer of _cap (a power of two) slots, [head, head + size) are constructed
+    struct block {
+        T     *data;
+        size_t head;
+        size_t size;
+        size_t mask;
+
+        T &operator[](size_t j) {
+            return data[(head + j) & mask];
+        }
+        const T &operator[](size_t j) const {
+            return data[(head + j) & mask];
+        }
+        bool full() const {
+            return size == mask + 1;
+        }
+        template<typename U>
+        void push_back(U &&value) {
+            std::construct_at(data + ((head + size) & mask), std::forward<U>(value));
+            ++size;
+        }
+        template<typename U>
+        void push_front(U &&value) {
+            size_t h = (head - 1) & mask;
+            std::construct_at(data + h, std::forward<U>(value));
+            head = h;
+            ++size;
+        }
+        T pop_back() {
+            T *p = &(*this)[size - 1];
+            T tmp(std::move(*p));
+            std::destroy_at(p);
+            --size;
+            return tmp;
+        }
+        T pop_front() {
+            T *p = data + head;
+            T tmp(std::move(*p));
+            std::destroy_at(p);
+            head = (head + 1) & mask;
+            --size;
+            return tmp;
+        }
+        // insert before slot j, the block must not be full
+        void insert(size_t j, T &&value) {
+            if (j == size) {
+                push_back(std::move(value));
+                return;
+            }
+            push_back(std::move((*this)[size - 1]));
+            for (size_t i = size - 2; i > j; --i) (*this)[i] = std::move((*this)[i - 1]);
+            (*this)[j] = std::move(value);
+        }
+        void erase(size_t j) {
+            for (size_t i = j; i + 1 < size; ++i) (*this)[i] = std::move((*this)[i + 1]);
+            std::destroy_at(&(*this)[size - 1]);
+            --size;
+        }
+    };
+
+    vector<block *>    _m_blocks;
+    size_t             _m_size;
+    size_t             _m_block_size; // B
+    std::allocator<T>  _alloc;
+
+  public:
+    class const_iterator;
+    class iterator {
+      public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::random_access_iterator_tag;
+        friend class tiered_vector;
+
+      private:
+        tiered_vector *_tv;
+        size_t         _idx;
+        iterator(tiered_vector *tv, size_t idx) : _tv(tv), _idx(idx) {}
+
+      public:
+        iterator() : _tv(nullptr), _idx(0) {}
+        iterator operator+(const difference_type &n) const {
+            return iterator(_tv, _idx + n);
+        }
+        friend iterator operator+(const difference_type &n, const iterator &it) {
+            return it + n;
+        }
+        iterator operator-(const difference_type &n) const {
+            return iterator(_tv, _idx - n);
+        }
+        // if these two iterators point to different containers, throw invaild_iterator.
+        difference_type operator-(const iterator &rhs) const {
+            if (_tv != rhs._tv) throw invalid_iterator();
+            return difference_type(_idx) - difference_type(rhs._idx);
+        }
+        iterator &operator+=(const difference_type &n) {
+            _idx += n;
+            return *this;
+        }
+        iterator &operator-=(const difference_type &n) {
+            _idx -= n;
+            return *this;
+        }
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++_idx;
+            return tmp;
+        }
+        iterator &operator++() {
+            ++_idx;
+            return *this;
+        }
+        iterator operator--(int) {
+            auto tmp = *this;
+            --_idx;
+            return tmp;
+        }
+        iterator &operator--() {
+            --_idx;
+            return *this;
+        }
+        T &operator*() const {
+            return _tv->_get(_idx);
+        }
+        T *operator->() const {
+            return &_tv->_get(_idx);
+        }
+        T &operator[](const difference_type &n) const {
+            return _tv->_get(_idx + n);
+        }
+        bool operator==(const iterator &rhs) const {
+            return _tv == rhs._tv && _idx == rhs._idx;
+        }
+        bool operator!=(const iterator &rhs) const {
+            return !(*this == rhs);
+        }
+        auto operator<=>(const iterator &rhs) const {
+            return _idx <=> rhs._idx;
+        }
+    };
+    class const_iterator {
+      public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::random_access_iterator_tag;
+        friend class tiered_vector;
+
+      private:
+        const tiered_vector *_tv;
+        size_t               _idx;
+        const_iterator(const tiered_vector *tv, size_t idx) : _tv(tv), _idx(idx) {}
+
+      public:
+        const_iterator() : _tv(nullptr), _idx(0) {}
+        const_iterator(const iterator &other) : _tv(other._tv), _idx(other._idx) {}
+        const_iterator operator+(const difference_type &n) const {
+            return const_iterator(_tv, _idx + n);
+        }
+        friend const_iterator operator+(const difference_type &n, const const_iterator &it) {
+            return it + n;
+        }
+        const_iterator operator-(const difference_type &n) const {
+            return const_iterator(_tv, _idx - n);
+        }
+        difference_type operator-(const const_iterator &rhs) const {
+            if (_tv != rhs._tv) throw invalid_iterator();
+            return difference_type(_idx) - difference_type(rhs._idx);
+        }
+        const_iterator &operator+=(const difference_type &n) {
+            _idx += n;
+            return *this;
+        }
+        const_iterator &operator-=(const difference_type &n) {
+            _idx -= n;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            ++_idx;
+            return tmp;
+        }
+        const_iterator &operator++() {
+            ++_idx;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto tmp = *this;
+            --_idx;
+            return tmp;
+        }
+        const_iterator &operator--() {
+            --_idx;
+            return *this;
+        }
+        const T &operator*() const {
+            return _tv->_get(_idx);
+        }
+        const T *operator->() const {
+            return &_tv->_get(_idx);
+        }
+        const T &operator[](const difference_type &n) const {
+            return _tv->_get(_idx + n);
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return _tv == rhs._tv && _idx == rhs._idx;
+        }
+        bool operator!=(const const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+        auto operator<=>(const const_iterator &rhs) const {
+            return _idx <=> rhs._idx;
+        }
+    };
+    /**
+     * constructors
+     */
+    tiered_vector() : _m_size(0), _m_block_size(MIN_BLOCK) {}
+    tiered_vector(const tiered_vector &other) : _m_size(0), _m_block_size(other._m_block_size) {
+        for (size_t i = 0; i < other._m_size; ++i) push_back(other._get(i));
+    }
+    tiered_vector(tiered_vector &&other) noexcept
+        : _m_blocks(std::move(other._m_blocks)), _m_size(other._m_size), _m_block_size(other._m_block_size) {
+        other._m_size = 0;
+        other._m_block_size = MIN_BLOCK;
+    }
+    /**
+     * destructor
+     */
+    ~tiered_vector() {
+        clear();
+    }
+    /**
+     * assignment operators
+     */
+    tiered_vector &operator=(const tiered_vector &other) {
+        if (this == &other) return *this;
+        clear();
+        _m_block_size = other._m_block_size;
+        for (size_t i = 0; i < other._m_size; ++i) push_back(other._get(i));
+        return *this;
+    }
+    tiered_vector &operator=(tiered_vector &&other) noexcept {
+        if (this == &other) return *this;
+        clear();
+        _m_blocks = std::move(other._m_blocks);
+        _m_size = other._m_size;
+        _m_block_size = other._m_block_size;
+        other._m_size = 0;
+        other._m_block_size = MIN_BLOCK;
+        return *this;
+    }
+    /**
+     * assigns specified element with bounds checking
+     * throw index_out_of_bound if pos is not in [0, size)
+     */
+    T &at(const size_t &pos) {
+        if (pos >= _m_size) throw index_out_of_bound();
+        return _get(pos);
+    }
+    const T &at(const size_t &pos) const {
+        if (pos >= _m_size) throw index_out_of_bound();
+        return _get(pos);
+    }
+    T &operator[](const size_t &pos) {
+        return at(pos);
+    }
+    const T &operator[](const size_t &pos) const {
+        return at(pos);
+    }
+    /**
+     * access the first / last element.
+     * throw container_is_empty if size == 0
+     */
+    const T &front() const {
+        if (_m_size == 0) throw container_is_empty();
+        return _get(0);
+    }
+    const T &back() const {
+        if (_m_size == 0) throw container_is_empty();
+        return _get(_m_size - 1);
+    }
+    /**
+     * iterators to the beginning and the end.
+     */
+    iterator begin() {
+        return iterator(this, 0);
+    }
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+    const_iterator cbegin() const {
+        return const_iterator(this, 0);
+    }
+    iterator end() {
+        return iterator(this, _m_size);
+    }
+    const_iterator end() const {
+        return const_iterator(this, _m_size);
+    }
+    const_iterator cend() const {
+        return const_iterator(this, _m_size);
+    }
+    /**
+     * checks whether the container is empty
+     */
+    bool empty() const {
+        return _m_size == 0;
+    }
+    /**
+     * returns the number of elements
+     */
+    size_t size() const {
+        return _m_size;
+    }
+    /**
+     * clears the contents
+     */
+    void clear() {
+        for (size_t b = 0; b < _m_blocks.size(); ++b) _free_block(_m_blocks[b]);
+        _m_blocks.clear();
+        _m_size = 0;
+        _m_block_size = MIN_BLOCK;
+    }
+    /**
+     * inserts value before pos / at index ind, in O(sqrt n).
+     * returns an iterator pointing to the inserted value.
+     * throw index_out_of_bound if ind > size
+     */
+    iterator insert(iterator pos, const T &value) {
+        return insert(pos._idx, value);
+    }
+    iterator insert(const size_t &ind, const T &value) {
+        if (ind > _m_size) throw index_out_of_bound();
+        T tmp(value); // value may be an element of this container
+        if (_m_blocks.empty() || _m_blocks.back()->full()) _m_blocks.push_back(_new_block(_m_block_size));
+        size_t k = ind / _m_block_size;
+        // every block after k hands its last element to the next one
+        for (size_t b = _m_blocks.size() - 1; b > k; --b) {
+            _m_blocks[b]->push_front(_m_blocks[b - 1]->pop_back());
+        }
+        _m_blocks[k]->insert(ind % _m_block_size, std::move(tmp));
+        ++_m_size;
+        _rebalance();
+        return iterator(this, ind);
+    }
+    /**
+     * removes the element at pos / with index ind, in O(sqrt n).
+     * return an iterator pointing to the following element.
+     * throw index_out_of_bound if ind >= size
+     */
+    iterator erase(iterator pos) {
+        return erase(pos._idx);
+    }
+    iterator erase(const size_t &ind) {
+        if (ind >= _m_size) throw index_out_of_bound();
+        size_t k = ind / _m_block_size;
+        _m_blocks[k]->erase(ind % _m_block_size);
+        // every block after k hands its first element to the previous one
+        for (size_t b = k + 1; b < _m_blocks.size(); ++b) {
+            _m_blocks[b - 1]->push_back(_m_blocks[b]->pop_front());
+        }
+        if (_m_blocks.back()->size == 0) {
+            _free_block(_m_blocks.back());
+            _m_blocks.pop_back();
+        }
+        --_m_size;
+        _rebalance();
+        return iterator(this, ind);
+    }
+    /**
+     * adds an element to the end.
+     */
+    void push_back(const T &value) {
+        T tmp(value);
+        if (_m_blocks.empty() || _m_blocks.back()->full()) _m_blocks.push_back(_new_block(_m_block_size));
+        _m_blocks.back()->push_back(std::move(tmp));
+        ++_m_size;
+        _rebalance();
+    }
+    /**
+     * remove the last element from the end.
+     * throw container_is_empty if size() == 0
+     */
+    void pop_back() {
+        if (_m_size == 0) throw container_is_empty();
+        erase(_m_size - 1);
+    }
+
+  private:
+    T &_get(size_t i) {
+        return (*_m_blocks[i / _m_block_size])[i % _m_block_size];
+    }
+    const T &_get(size_t i) const {
+        return (*_m_blocks[i / _m_block_size])[i % _m_block_size];
+    }
+
+    block *_new_block(size_t cap) {
+        block *b = new block;
+        b->data = _alloc.allocate(cap);
+        b->head = 0;
+        b->size = 0;
+        b->mask = cap - 1;
+        return b;
+    }
+
+    void _free_block(block *b) {
+        for (size_t j = 0; j < b->size; ++j) std::destroy_at(&(*b)[j]);
+        _alloc.deallocate(b->data, b->mask + 1);
+        delete b;
+    }
+
+    // keep B around sqrt(n): rebuild when n leaves [B^2 / 8, 2 B^2]
+    void _rebalance() {
+        size_t b = _m_block_size;
+        if (_m_size > 2 * b * b) _rebuild(b * 2);
+        else if (b > MIN_BLOCK && _m_size < b * b / 8) _rebuild(b / 2);
+    }
+
+    void _rebuild(size_t cap) {
+        vector<block *> blocks;
+        for (size_t b = 0; b < _m_blocks.size(); ++b) {
+            block *old = _m_blocks[b];
+            while (old->size > 0) {
+                if (blocks.empty() || blocks.back()->full()) blocks.push_back(_new_block(cap));
+                blocks.back()->push_back(old->pop_front());
+            }
+            _free_block(old);
+        }
+        _m_blocks = std::move(blocks);
+        _m_block_size = cap;
+    }
+};
+
+}
+
+#endif
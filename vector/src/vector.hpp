@@ -3,9 +3,18 @@
 
 #include "exceptions.hpp"
 
+#include <array>
 #include <climits>
 #include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace sjtu {
 /**
@@ -13,20 +22,55 @@ namespace sjtu {
  * store data in a successive memory and support random access.
  */
 template<typename T>
-T max(const T &x, const T &y) {
+constexpr T max(const T &x, const T &y) {
     return x > y ? x : y;
 }
 
+/**
+ * move n elements from src into the uninitialized dst, then destroy them in src.
+ * this is how vector (and the containers built like it) moves to a new buffer.
+ */
 template<typename T>
+constexpr void relocate_n(T *src, size_t n, T *dst) {
+    for (size_t i = 0; i < n; ++i) {
+        std::construct_at(dst + i, std::move_if_noexcept(src[i]));
+    }
+    for (size_t i = 0; i < n; ++i) {
+        std::destroy_at(src + i);
+    }
+}
+
+/**
+ * Alloc provides the storage, its pointer type is used for the buffer,
+ * so an allocator with a fancy pointer (e.g. offset_ptr for a vector
+ * living in shared memory) is supported.
+ */
+template<typename T, class Alloc = std::allocator<T>>
 class vector {
   private:
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+
     static constexpr double MULTIPLIER = 2;
-    T *_m_data;
+    /**
+     * buffers of at least LARGE_BUFFER bytes are mapped directly from the
+     * kernel, so growing them is a mremap (the pages are moved, not copied)
+     * and shrinking gives the pages back. Only for trivially copyable T with
+     * the default allocator, since the elements are moved as raw bytes.
+     */
+#ifdef __linux__
+    static constexpr bool USE_MREMAP = std::is_trivially_copyable_v<T>
+                                       && std::is_same_v<Alloc, std::allocator<T>>;
+#else
+    static constexpr bool USE_MREMAP = false;
+#endif
+    static constexpr size_t LARGE_BUFFER = size_t(1) << 21;
+    pointer _m_data;
     size_t _m_size;
     size_t _m_cap;
-    std::allocator<T> _alloc;
+    [[no_unique_address]] Alloc _alloc;
 
   public:
+    using allocator_type = Alloc;
     /**
      * TODO
      * a type for actions of the elements of a vector, and you should write
@@ -53,83 +97,97 @@ class vector {
         using value_type = T;
         using pointer = T*;
         using reference = T&;
-        using iterator_category = std::output_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
         friend class vector;
 
       private:
         T *_m_ptr;
-        const vector *const _vec;
-        iterator(T *_ptr, const vector *__vec) : _m_ptr(_ptr), _vec(__vec) {}
+        const vector *_vec;
+        constexpr iterator(T *_ptr, const vector *__vec) : _m_ptr(_ptr), _vec(__vec) {}
 
       public:
+        constexpr iterator() : _m_ptr(nullptr), _vec(nullptr) {}
         /**
          * return a new iterator which pointer n-next elements
          * as well as operator-
          */
-        iterator operator+(const int &n) const {
+        constexpr iterator operator+(const difference_type &n) const {
             return iterator(_m_ptr + n, _vec);
         }
-        iterator operator-(const int &n) const {
+        friend constexpr iterator operator+(const difference_type &n, const iterator &it) {
+            return it + n;
+        }
+        constexpr iterator operator-(const difference_type &n) const {
             return iterator(_m_ptr - n, _vec);
         }
         // return the distance between two iterators,
         // if these two iterators point to different vectors, throw invaild_iterator.
-        int operator-(const iterator &rhs) const {
+        constexpr difference_type operator-(const iterator &rhs) const {
             if (_vec != rhs._vec) throw invalid_iterator();
             return _m_ptr - rhs._m_ptr;
         }
-        iterator &operator+=(const int &n) {
+        constexpr iterator &operator+=(const difference_type &n) {
             _m_ptr += n;
             return *this;
         }
-        iterator &operator-=(const int &n) {
+        constexpr iterator &operator-=(const difference_type &n) {
             _m_ptr -= n;
             return *this;
         }
 
-        iterator operator++(int) {
+        constexpr iterator operator++(int) {
             auto tmp = *this;
             ++_m_ptr;
             return tmp;
         }
 
-        iterator &operator++() {
+        constexpr iterator &operator++() {
             ++_m_ptr;
             return *this;
         }
 
-        iterator operator--(int) {
+        constexpr iterator operator--(int) {
             auto tmp = *this;
             --_m_ptr;
             return tmp;
         }
 
-        iterator &operator--() {
+        constexpr iterator &operator--() {
             --_m_ptr;
             return *this;
         }
 
-        T &operator*() const {
+        constexpr T &operator*() const {
             return *_m_ptr;
         }
+        constexpr T *operator->() const {
+            return _m_ptr;
+        }
+        constexpr T &operator[](const difference_type &n) const {
+            return _m_ptr[n];
+        }
         /**
          * a operator to check whether two iterators are same (pointing to the same memory address).
          */
-        bool operator==(const iterator &rhs) const {
+        constexpr bool operator==(const iterator &rhs) const {
             return _m_ptr == rhs._m_ptr;
         }
-        bool operator==(const const_iterator &rhs) const {
+        constexpr bool operator==(const const_iterator &rhs) const {
             return _m_ptr == rhs._m_cptr;
         }
         /**
          * some other operator for iterator.
          */
-        bool operator!=(const iterator &rhs) const {
+        constexpr bool operator!=(const iterator &rhs) const {
             return _m_ptr != rhs._m_ptr;
         }
-        bool operator!=(const const_iterator &rhs) const {
+        constexpr bool operator!=(const const_iterator &rhs) const {
             return _m_ptr != rhs._m_cptr;
         }
+        constexpr auto operator<=>(const iterator &rhs) const {
+            return _m_ptr <=> rhs._m_ptr;
+        }
     };
     /**
      * TODO
@@ -139,111 +197,132 @@ class vector {
       public:
         using difference_type = std::ptrdiff_t;
         using value_type = T;
-        using pointer = T*;
-        using reference = T&;
-        using iterator_category = std::output_iterator_tag;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
 
       private:
         /*TODO*/
         const T *_m_cptr;
-        const vector *const _vec;
-        const_iterator(const T *_ptr, const vector *__vec) : _m_cptr(_ptr), _vec(__vec) {}
-        const_iterator(const iterator &other) : _m_cptr(other._m_ptr), _vec(other._vec) {}
+        const vector *_vec;
+        constexpr const_iterator(const T *_ptr, const vector *__vec) : _m_cptr(_ptr), _vec(__vec) {}
         friend class vector;
 
       public:
-        const_iterator operator+(const int &n) const {
+        constexpr const_iterator() : _m_cptr(nullptr), _vec(nullptr) {}
+        constexpr const_iterator(const iterator &other) : _m_cptr(other._m_ptr), _vec(other._vec) {}
+        constexpr const_iterator operator+(const difference_type &n) const {
             return const_iterator(_m_cptr + n, _vec);
         }
-        const_iterator operator-(const int &n) const {
+        friend constexpr const_iterator operator+(const difference_type &n, const const_iterator &it) {
+            return it + n;
+        }
+        constexpr const_iterator operator-(const difference_type &n) const {
             return const_iterator(_m_cptr - n, _vec);
         }
         // return the distance between two iterators,
         // if these two iterators point to different vectors, throw invaild_iterator.
-        int operator-(const const_iterator &rhs) const {
+        constexpr difference_type operator-(const const_iterator &rhs) const {
             if (_vec != rhs._vec) throw invalid_iterator();
             return _m_cptr - rhs._m_cptr;
         }
-        const_iterator &operator+=(const int &n) {
+        constexpr const_iterator &operator+=(const difference_type &n) {
             _m_cptr += n;
             return *this;
         }
-        const_iterator &operator-=(const int &n) {
+        constexpr const_iterator &operator-=(const difference_type &n) {
             _m_cptr -= n;
             return *this;
         }
 
-        const_iterator operator++(int) {
+        constexpr const_iterator operator++(int) {
             auto tmp = *this;
             ++_m_cptr;
             return tmp;
         }
 
-        const_iterator &operator++() {
+        constexpr const_iterator &operator++() {
             ++_m_cptr;
             return *this;
         }
 
-        const_iterator operator--(int) {
+        constexpr const_iterator operator--(int) {
             auto tmp = *this;
             --_m_cptr;
             return tmp;
         }
 
-        const_iterator &operator--() {
+        constexpr const_iterator &operator--() {
             --_m_cptr;
             return *this;
         }
 
-        const T &operator*() const {
+        constexpr const T &operator*() const {
             return *_m_cptr;
         }
+        constexpr const T *operator->() const {
+            return _m_cptr;
+        }
+        constexpr const T &operator[](const difference_type &n) const {
+            return _m_cptr[n];
+        }
         /**
          * a operator to check whether two iterators are same (pointing to the same memory address).
          */
-        bool operator==(const iterator &rhs) const {
+        constexpr bool operator==(const iterator &rhs) const {
             return _m_cptr == rhs._m_ptr;
         }
-        bool operator==(const const_iterator &rhs) const {
+        constexpr bool operator==(const const_iterator &rhs) const {
             return _m_cptr == rhs._m_cptr;
         }
         /**
          * some other operator for iterator.
          */
-        bool operator!=(const iterator &rhs) const {
+        constexpr bool operator!=(const iterator &rhs) const {
             return _m_cptr != rhs._m_ptr;
         }
-        bool operator!=(const const_iterator &rhs) const {
+        constexpr bool operator!=(const const_iterator &rhs) const {
             return _m_cptr != rhs._m_cptr;
         }
-
+        constexpr auto operator<=>(const const_iterator &rhs) const {
+            return _m_cptr <=> rhs._m_cptr;
+        }
     };
     /**
      * TODO Constructs
      * At least two: default constructor, copy constructor
      */
-    vector() : _m_data(nullptr), _m_cap(0), _m_size(0) {}
-    vector(const vector &other) {
-        _m_data = _alloc.allocate(other._m_cap);
+    constexpr vector() : _m_data(nullptr), _m_cap(0), _m_size(0) {}
+    constexpr explicit vector(const Alloc &alloc) : _m_data(nullptr), _m_size(0), _m_cap(0), _alloc(alloc) {}
+    constexpr vector(const vector &other)
+        : _alloc(std::allocator_traits<Alloc>::select_on_container_copy_construction(other._alloc)) {
+        _m_data = _allocate(other._m_cap);
         _m_size = other._m_size;
         _m_cap = other._m_cap;
         for (int i = 0; i < _m_size; ++i) {
             std::construct_at(_m_data + i, std::as_const(other._m_data[i]));
         }
     }
+    constexpr vector(vector &&other) noexcept
+        : _m_data(other._m_data), _m_size(other._m_size), _m_cap(other._m_cap), _alloc(std::move(other._alloc)) {
+        other._m_data = nullptr;
+        other._m_size = 0;
+        other._m_cap = 0;
+    }
     /**
      * TODO Destructor
      */
-    ~vector() {
+    constexpr ~vector() {
         clear();
     }
     /**
      * TODO Assignment operator
      */
-    vector &operator=(const vector &other) {
+    constexpr vector &operator=(const vector &other) {
         if (this == &other) return *this;
         clear();
-        _m_data = _alloc.allocate(other._m_cap);
+        _m_data = _allocate(other._m_cap);
         _m_size = other._m_size;
         _m_cap = other._m_cap;
         for (int i = 0; i < _m_size; ++i) {
@@ -251,15 +330,27 @@ class vector {
         }
         return *this;
     }
+    constexpr vector &operator=(vector &&other) noexcept {
+        if (this == &other) return *this;
+        clear();
+        _m_data = other._m_data;
+        _m_size = other._m_size;
+        _m_cap = other._m_cap;
+        _alloc = std::move(other._alloc);
+        other._m_data = nullptr;
+        other._m_size = 0;
+        other._m_cap = 0;
+        return *this;
+    }
     /**
      * assigns specified element with bounds checking
      * throw index_out_of_bound if pos is not in [0, size)
      */
-    T &at(const size_t &pos) {
+    constexpr T &at(const size_t &pos) {
         if (pos < 0 || pos >= _m_size) throw index_out_of_bound();
         return _m_data[pos];
     }
-    const T &at(const size_t &pos) const {
+    constexpr const T &at(const size_t &pos) const {
         if (pos < 0 || pos >= _m_size) throw index_out_of_bound();
         return _m_data[pos];
     }
@@ -269,17 +360,17 @@ class vector {
      * !!! Pay attentions
      *   In STL this operator does not check the boundary but I want you to do.
      */
-    T &operator[](const size_t &pos) {
+    constexpr T &operator[](const size_t &pos) {
         return at(pos);
     }
-    const T &operator[](const size_t &pos) const {
+    constexpr const T &operator[](const size_t &pos) const {
         return at(pos);
     }
     /**
      * access the first element.
      * throw container_is_empty if size == 0
      */
-    const T &front() const {
+    constexpr const T &front() const {
         if (_m_size == 0) throw container_is_empty();
         return _m_data[0];
     }
@@ -287,55 +378,71 @@ class vector {
      * access the last element.
      * throw container_is_empty if size == 0
      */
-    const T &back() const {
+    constexpr const T &back() const {
         if (_m_size == 0) throw container_is_empty();
         return _m_data[_m_size - 1];
     }
+    /**
+     * returns a pointer to the underlying array,
+     * the elements are stored successively in [data(), data() + size()).
+     */
+    constexpr T *data() {
+        return _m_data;
+    }
+    constexpr const T *data() const {
+        return _m_data;
+    }
     /**
      * returns an iterator to the beginning.
      */
-    iterator begin() {
+    constexpr iterator begin() {
         return iterator(_m_data, this);
     }
-    const_iterator cbegin() const {
+    constexpr const_iterator begin() const {
+        return const_iterator(_m_data, this);
+    }
+    constexpr const_iterator cbegin() const {
         return const_iterator(_m_data, this);
     }
     /**
      * returns an iterator to the end.
      */
-    iterator end() {
+    constexpr iterator end() {
         return iterator(_m_data + _m_size, this);
     }
-    const_iterator cend() const {
+    constexpr const_iterator end() const {
+        return const_iterator(_m_data + _m_size, this);
+    }
+    constexpr const_iterator cend() const {
         return const_iterator(_m_data + _m_size, this);
     }
     /**
      * checks whether the container is empty
      */
-    bool empty() const {
+    constexpr bool empty() const {
         return _m_size == 0;
     }
     /**
      * returns the number of elements
      */
-    size_t size() const {
+    constexpr size_t size() const {
         return _m_size;
     }
     /**
      * returns the number of elements that can be held in currently allocated storage.
      */
-    size_t capacity() const {
+    constexpr size_t capacity() const {
         return _m_cap;
     }
     /**
      * clears the contents
      */
-    void clear() {
+    constexpr void clear() {
         if (_m_data == nullptr) return;
         for (int i = 0; i < _m_size; ++i) {
             std::destroy_at(_m_data + i);
         }
-        _alloc.deallocate(_m_data, _m_cap);
+        _deallocate(_m_data, _m_cap);
         _m_data = nullptr;
         _m_size = 0;
         _m_cap = 0;
@@ -344,7 +451,7 @@ class vector {
      * inserts value before pos
      * returns an iterator pointing to the inserted value.
      */
-    iterator insert(iterator pos, const T &value) {
+    constexpr iterator insert(iterator pos, const T &value) {
         return insert(pos - begin(), value);
     }
     /**
@@ -353,7 +460,7 @@ class vector {
      * returns an iterator pointing to the inserted value.
      * throw index_out_of_bound if ind > size (in this situation ind can be size because after inserting the size will increase 1.)
      */
-    iterator insert(const size_t &ind, const T &value) {
+    constexpr iterator insert(const size_t &ind, const T &value) {
         if (ind > _m_size) throw index_out_of_bound();
         _grow_capacity_until(_m_size + 1);
         for (size_t i = _m_size; i > ind; --i) {
@@ -376,7 +483,7 @@ class vector {
      * return an iterator pointing to the following element.
      * If the iterator pos refers the last element, the end() iterator is returned.
      */
-    iterator erase(iterator pos) {
+    constexpr iterator erase(iterator pos) {
         return erase(pos - begin());
     }
     /**
@@ -384,7 +491,7 @@ class vector {
      * return an iterator pointing to the following element.
      * throw index_out_of_bound if ind >= size
      */
-    iterator erase(const size_t &ind) {
+    constexpr iterator erase(const size_t &ind) {
         if (ind >= _m_size) throw index_out_of_bound();
         --_m_size;
         for (size_t i = ind; i < _m_size; ++i) {
@@ -397,16 +504,21 @@ class vector {
     /**
      * adds an element to the end.
      */
-    void push_back(const T &value) {
+    constexpr void push_back(const T &value) {
         _grow_capacity_until(_m_size + 1);
         std::construct_at(_m_data + _m_size, value);
         ++_m_size;
     }
+    constexpr void push_back(T &&value) {
+        _grow_capacity_until(_m_size + 1);
+        std::construct_at(_m_data + _m_size, std::move(value));
+        ++_m_size;
+    }
     /**
      * remove the last element from the end.
      * throw container_is_empty if size() == 0
      */
-    void pop_back() {
+    constexpr void pop_back() {
         if (_m_size == 0) throw container_is_empty();
         std::destroy_at(_m_data + _m_size - 1);
         --_m_size;
@@ -414,41 +526,119 @@ class vector {
     }
 
   private:
-    void _grow_capacity_until(size_t n) {
-        if (n <= _m_cap) return;
-        n = max(n, size_t(_m_cap * MULTIPLIER));
+    // whether a buffer of cap elements lives in its own mapping
+    constexpr bool _is_mapped(size_t cap) const {
+        if constexpr (!USE_MREMAP) return false;
+        else return !std::is_constant_evaluated() && cap * sizeof(T) >= LARGE_BUFFER;
+    }
+    // the length of the mapping holding cap elements
+    static size_t _mapped_bytes(size_t cap) {
+#ifdef __linux__
+        size_t page = sysconf(_SC_PAGESIZE);
+        return (cap * sizeof(T) + page - 1) / page * page;
+#else
+        return cap * sizeof(T);
+#endif
+    }
+    // round a large capacity up so that it fills its last page
+    static size_t _mapped_capacity(size_t cap) {
+        return _mapped_bytes(cap) / sizeof(T);
+    }
+    constexpr pointer _allocate(size_t n) {
+#ifdef __linux__
+        if (_is_mapped(n)) {
+            void *p = mmap(nullptr, _mapped_bytes(n), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+            return static_cast<T *>(p);
+        }
+#endif
+        return _alloc.allocate(n);
+    }
+    constexpr void _deallocate(pointer p, size_t n) {
+#ifdef __linux__
+        if (_is_mapped(n)) {
+            munmap(p, _mapped_bytes(n));
+            return;
+        }
+#endif
+        _alloc.deallocate(p, n);
+    }
+    // move the elements into a new buffer of n elements
+    constexpr void _reallocate(size_t n) {
         auto old_data = _m_data;
-        _m_data = _alloc.allocate(n);
+        _m_data = _allocate(n);
         if (old_data) {
-            for (size_t i = 0; i < _m_size; ++i) {
-                std::construct_at(_m_data + i, std::move_if_noexcept(old_data[i]));
-            }
-            for (size_t i = 0; i < _m_size; ++i) {
-                std::destroy_at(old_data + i);
-            }
-            _alloc.deallocate(old_data, _m_cap);
+            relocate_n<T>(old_data, _m_size, _m_data);
+            _deallocate(old_data, _m_cap);
         }
         _m_cap = n;
     }
-    void _shrink_capacity() {
+    // resize the mapping in place or let the kernel move its pages
+    bool _remap(size_t n) {
+#ifdef __linux__
+        if (!_m_data || !_is_mapped(_m_cap) || !_is_mapped(n)) return false;
+        size_t old_bytes = _mapped_bytes(_m_cap), new_bytes = _mapped_bytes(n);
+        if (new_bytes < old_bytes) {
+            // shrinking never moves: drop the pages, then the tail of the mapping
+            madvise(static_cast<char *>(static_cast<void *>(_m_data)) + new_bytes, old_bytes - new_bytes, MADV_DONTNEED);
+        }
+        void *p = mremap(_m_data, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            if (new_bytes > old_bytes) throw std::bad_alloc();
+            return true; // the pages are released already, keep the old length
+        }
+        _m_data = static_cast<T *>(p);
+        _m_cap = n;
+        return true;
+#else
+        return false;
+#endif
+    }
+    constexpr void _grow_capacity_until(size_t n) {
+        if (n <= _m_cap) return;
+        n = max(n, size_t(_m_cap * MULTIPLIER));
+        if (_is_mapped(n)) n = _mapped_capacity(n);
+        if (!std::is_constant_evaluated() && _remap(n)) return;
+        _reallocate(n);
+    }
+    constexpr void _shrink_capacity() {
         if (_m_size * MULTIPLIER >= _m_cap) return ;
-        int n = _m_cap / MULTIPLIER;
-        auto old_data = _m_data;
-        _m_data = _alloc.allocate(n);
-        if (old_data) {
-            for (size_t i = 0; i < _m_size; ++i) {
-                std::construct_at(_m_data + i, std::move_if_noexcept(old_data[i]));
-            }
-            for (size_t i = 0; i < _m_size; ++i) {
-                std::destroy_at(old_data + i);
-            }
-            _alloc.deallocate(old_data, _m_cap);
+        size_t n = _m_cap / MULTIPLIER;
+        if (_is_mapped(n)) {
+            n = _mapped_capacity(n);
+            if (n >= _m_cap) return;
         }
-        _m_cap = n;
+        if (!std::is_constant_evaluated() && _remap(n)) return;
+        _reallocate(n);
     }
 
 };
 
+/**
+ * copy a vector of exactly N elements into a std::array.
+ * throw index_out_of_bound if vec.size() != N
+ */
+template<size_t N, typename T>
+constexpr std::array<T, N> to_array(const vector<T> &vec) {
+    if (vec.size() != N) throw index_out_of_bound();
+    return [&]<size_t... I>(std::index_sequence<I...>) {
+        return std::array<T, N>{vec[I]...};
+    }(std::make_index_sequence<N>());
+}
+
+/**
+ * run make() at compile time and freeze the vector it returns into a std::array,
+ *   the size of the array is taken from the result.
+ * e.g. constexpr auto squares = sjtu::freeze<[] {
+ *          sjtu::vector<int> v;
+ *          for (int i = 0; i < 16; ++i) v.push_back(i * i);
+ *          return v;
+ *      }>();
+ */
+template<auto make>
+consteval auto freeze() {
+    return to_array<make().size()>(make());
+}
 
 }
 
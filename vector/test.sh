@@ -2,6 +2,18 @@ mkdir testdir
 cp src/vector.hpp testdir
 cp src/exceptions.hpp testdir
 cp src/utility.hpp testdir
+cp src/shared_memory.hpp testdir
+cp src/shm_vector.hpp testdir
+cp src/hive.hpp testdir
+cp src/devector.hpp testdir
+cp src/static_vector.hpp testdir
+cp src/poly_vector.hpp testdir
+cp src/static_index.hpp testdir
+cp src/slot_map.hpp testdir
+cp src/radix_sort.hpp testdir
+cp src/compressed_int_vector.hpp testdir
+cp src/roaring_bitmap.hpp testdir
+cp src/jagged_vector.hpp testdir
 cp data/class-bint.hpp testdir
 cp data/class-integer.hpp testdir
 cp data/class-matrix.hpp testdir
@@ -83,4 +95,232 @@ fi
 # else
 #     echo "Test four failed"
 #     exit 1
-# fi
\ No newline at end of file
+# fi
+
+echo "Running test five"
+cp data/five/code.cpp testdir
+cp data/five/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20
+if [ $? -eq 0 ]; then
+    echo "Test five compiled successfully"
+else
+    echo "Test five compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test five passed"
+else
+    echo "Test five failed"
+    exit 1
+fi
+
+echo "Running test six"
+cp data/six/code.cpp testdir
+cp data/six/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test six compiled successfully"
+else
+    echo "Test six compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test six passed"
+else
+    echo "Test six failed"
+    exit 1
+fi
+
+echo "Running test seven"
+cp data/seven/code.cpp testdir
+cp data/seven/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test seven compiled successfully"
+else
+    echo "Test seven compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test seven passed"
+else
+    echo "Test seven failed"
+    exit 1
+fi
+
+echo "Running test eight"
+cp data/eight/code.cpp testdir
+cp data/eight/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test eight compiled successfully"
+else
+    echo "Test eight compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test eight passed"
+else
+    echo "Test eight failed"
+    exit 1
+fi
+
+echo "Running test nine"
+cp data/nine/code.cpp testdir
+cp data/nine/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test nine compiled successfully"
+else
+    echo "Test nine compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test nine passed"
+else
+    echo "Test nine failed"
+    exit 1
+fi
+
+echo "Running test ten"
+cp data/ten/code.cpp testdir
+cp data/ten/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test ten compiled successfully"
+else
+    echo "Test ten compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test ten passed"
+else
+    echo "Test ten failed"
+    exit 1
+fi
+
+echo "Running test eleven"
+cp data/eleven/code.cpp testdir
+cp data/eleven/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test eleven compiled successfully"
+else
+    echo "Test eleven compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test eleven passed"
+else
+    echo "Test eleven failed"
+    exit 1
+fi
+
+echo "Running test twelve"
+cp data/twelve/code.cpp testdir
+cp data/twelve/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test twelve compiled successfully"
+else
+    echo "Test twelve compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test twelve passed"
+else
+    echo "Test twelve failed"
+    exit 1
+fi
+
+echo "Running test thirteen"
+cp data/thirteen/code.cpp testdir
+cp data/thirteen/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test thirteen compiled successfully"
+else
+    echo "Test thirteen compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test thirteen passed"
+else
+    echo "Test thirteen failed"
+    exit 1
+fi
+
+echo "Running test fourteen"
+cp data/fourteen/code.cpp testdir
+cp data/fourteen/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test fourteen compiled successfully"
+else
+    echo "Test fourteen compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test fourteen passed"
+else
+    echo "Test fourteen failed"
+    exit 1
+fi
+
+echo "Running test fifteen"
+cp data/fifteen/code.cpp testdir
+cp data/fifteen/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test fifteen compiled successfully"
+else
+    echo "Test fifteen compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test fifteen passed"
+else
+    echo "Test fifteen failed"
+    exit 1
+fi
+
+echo "Running test sixteen"
+cp data/sixteen/code.cpp testdir
+cp data/sixteen/answer.txt testdir
+g++ testdir/code.cpp -o testdir/code -fmax-errors=10 -O2 -DONLINE_JUDGE -lm -std=c++20 -fsanitize=address
+if [ $? -eq 0 ]; then
+    echo "Test sixteen compiled successfully"
+else
+    echo "Test sixteen compiled failed"
+    exit 2
+fi
+./testdir/code > testdir/output.txt
+diff testdir/output.txt testdir/answer.txt
+if [ $? -eq 0 ]; then
+    echo "Test sixteen passed"
+else
+    echo "Test sixteen failed"
+    exit 1
+fi